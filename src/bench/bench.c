@@ -0,0 +1,230 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+/*
+    Microbenchmarks of the hot paths of glib. It renders headless, so it runs on CI machines too,
+    e.g. with Mesa's software rasterizer: LIBGL_ALWAYS_SOFTWARE=1 ./bin/bench bench.json
+
+    The results are written as JSON (to stdout without a file argument):
+    ns_per_op is the wall time of one operation, ops_per_frame is how many fit into a 60 fps frame
+*/
+
+#define BENCH_FRAME_NS (1e9/60.0)
+
+typedef struct {
+    const char* name;
+    unsigned long long ops;
+    double ns_per_op;
+} bench_result_t;
+
+bench_result_t bench_results[64];
+int bench_result_count = 0;
+
+glib_obj_t* bench_quad;
+
+float bench_quad_vertices[] = {
+    -0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f,
+     0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+     0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,
+    -0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
+};
+
+unsigned int bench_quad_indices[] = {
+    0, 1, 2,
+    0, 2, 3
+};
+
+double bench_now(void){
+    return (double)glfwGetTimerValue()/(double)glfwGetTimerFrequency();
+}
+
+// glFinish is part of the measured time, so the GPU work of the operations is counted too
+void bench_report(const char* name, unsigned long long ops, double start){
+    glFinish();
+    double elapsed = bench_now()-start;
+    bench_result_t* result = &bench_results[bench_result_count++];
+    result->name = name;
+    result->ops = ops;
+    result->ns_per_op = elapsed*1e9/(double)ops;
+    fprintf(stderr, "%-32s %12.1f ns/op %14.1f ops/frame\n", name, result->ns_per_op, BENCH_FRAME_NS/result->ns_per_op);
+}
+
+void bench_create_obj(void){
+    enum { N = 2000 };
+    static glib_obj_t* objs[N];
+    double start = bench_now();
+    for(int i = 0; i<N; i++){
+        objs[i] = glib_create_obj(bench_quad_vertices, GLIB_ARRAY_LEN(bench_quad_vertices), bench_quad_indices, GLIB_ARRAY_LEN(bench_quad_indices));
+    }
+    bench_report("glib_create_obj", N, start);
+    for(int i = 0; i<N; i++){
+        glib_destroy_obj(objs[i]);
+    }
+    glib_collect_garbage(true);
+}
+
+void bench_create_quad_obj(void){
+    enum { N = 2000 };
+    static glib_obj_t* objs[N];
+    double start = bench_now();
+    for(int i = 0; i<N; i++){
+        objs[i] = glib_create_quad_obj(-0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f);
+    }
+    bench_report("glib_create_quad_obj", N, start);
+    for(int i = 0; i<N; i++){
+        glib_destroy_obj(objs[i]);
+    }
+    glib_collect_garbage(true);
+}
+
+void bench_draw_obj(void){
+    enum { FRAMES = 20, DRAWS = 5000 };
+    glib_use_shader(glib_default_shader);
+    glib_use_texture_2d(glib_default_tex, GLIB_TEX_SLOT0);
+    double start = bench_now();
+    for(int frame = 0; frame<FRAMES; frame++){
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        for(int i = 0; i<DRAWS; i++){
+            glib_draw_obj(bench_quad);
+        }
+    }
+    bench_report("glib_draw_obj", (unsigned long long)FRAMES*DRAWS, start);
+}
+
+void bench_draw_obj_instanced(void){
+    enum { FRAMES = 20, INSTANCES = 5000 };
+    static glib_instance_t instances[INSTANCES];
+    for(int i = 0; i<INSTANCES; i++){
+        glm_mat4_identity(instances[i].model);
+        glm_scale_uni(instances[i].model, 0.01f);
+        glm_vec4_copy((vec4){1.0f, 1.0f, 1.0f, 1.0f}, instances[i].color);
+    }
+    glib_set_obj_instances(bench_quad, instances, INSTANCES);
+    glib_use_shader(glib_get_default_instanced_shader());
+    double start = bench_now();
+    for(int frame = 0; frame<FRAMES; frame++){
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glib_draw_obj_instanced(bench_quad, INSTANCES);
+    }
+    bench_report("glib_draw_obj_instanced (per instance)", (unsigned long long)FRAMES*INSTANCES, start);
+    glib_use_shader(glib_default_shader);
+}
+
+void bench_uniforms(void){
+    enum { N = 200000 };
+    mat4 model;
+    glm_mat4_identity(model);
+    glib_use_shader(glib_default_shader);
+
+    double start = bench_now();
+    for(int i = 0; i<N; i++){
+        glib_set_uniform1i(glib_default_shader, "tex0", i&1);
+    }
+    bench_report("glib_set_uniform1i", N, start);
+
+    start = bench_now();
+    for(int i = 0; i<N; i++){
+        model[3][0] = (float)(i&1);
+        glib_set_unifrom_mat4(glib_default_shader, "model", model);
+    }
+    bench_report("glib_set_unifrom_mat4", N, start);
+
+    glib_uniform_handle_t handle = glib_get_uniform(glib_default_shader, "model");
+    start = bench_now();
+    for(int i = 0; i<N; i++){
+        model[3][0] = (float)(i&1);
+        glib_set_uniform_mat4_handle(handle, model);
+    }
+    bench_report("glib_set_uniform_mat4_handle", N, start);
+
+    // the cache drops the repeated uploads of the same value
+    start = bench_now();
+    for(int i = 0; i<N; i++){
+        glib_set_uniform_mat4_handle(handle, model);
+    }
+    bench_report("glib_set_uniform_mat4_handle (same)", N, start);
+
+    glm_mat4_identity(model);
+    glib_set_uniform_mat4_handle(handle, model);
+}
+
+void bench_texture_from_memory(void){
+    enum { N = 200 };
+    static unsigned int textures[N];
+    double start = bench_now();
+    for(int i = 0; i<N; i++){
+        textures[i] = glib_load_texture_2d_from_memory(glib_default_tex_jpg_raw, GLIB_ARRAY_LEN(glib_default_tex_jpg_raw), 0);
+    }
+    bench_report("glib_load_texture_2d_from_memory", N, start);
+    for(int i = 0; i<N; i++){
+        glib_destroy_texture(textures[i]);
+    }
+    glib_collect_garbage(true);
+}
+
+void bench_shader_compile(void){
+    enum { N = 20 };
+    static unsigned int programs[N];
+
+    glib_set_shader_cache_dir(NULL);
+    double start = bench_now();
+    for(int i = 0; i<N; i++){
+        programs[i] = glib_create_shader_from_memory(glib_default_vert, glib_default_frag);
+    }
+    bench_report("glib_create_shader_from_memory", N, start);
+    for(int i = 0; i<N; i++){
+        glib_destroy_shader(programs[i]);
+    }
+
+    // the first program fills the binary cache, the rest are loaded from it
+    glib_set_shader_cache_dir(GLIB_SHADER_CACHE_DIR);
+    glib_destroy_shader(glib_create_shader_from_memory(glib_default_vert, glib_default_frag));
+    start = bench_now();
+    for(int i = 0; i<N; i++){
+        programs[i] = glib_create_shader_from_memory(glib_default_vert, glib_default_frag);
+    }
+    bench_report("glib_create_shader_from_memory (binary cache)", N, start);
+    for(int i = 0; i<N; i++){
+        glib_destroy_shader(programs[i]);
+    }
+    glib_collect_garbage(true);
+    glib_use_shader(glib_default_shader);
+}
+
+bool bench_write_json(FILE* fp){
+    fprintf(fp, "{\n  \"renderer\": \"%s\",\n  \"version\": \"%s\",\n  \"results\": [\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    for(int i = 0; i<bench_result_count; i++){
+        bench_result_t* result = &bench_results[i];
+        fprintf(fp, "    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.2f, \"ops_per_frame\": %.2f}%s\n",
+            result->name, result->ops, result->ns_per_op, BENCH_FRAME_NS/result->ns_per_op, i+1<bench_result_count?",":"");
+    }
+    fprintf(fp, "  ]\n}\n");
+    return !ferror(fp);
+}
+
+int main(int argc, char** argv){
+    glib_init();
+    glib_create_headless(256, 256);
+    glBindFramebuffer(GL_FRAMEBUFFER, glib_headless.FBO);
+
+    bench_quad = glib_create_obj(bench_quad_vertices, GLIB_ARRAY_LEN(bench_quad_vertices), bench_quad_indices, GLIB_ARRAY_LEN(bench_quad_indices));
+
+    bench_create_obj();
+    bench_create_quad_obj();
+    bench_draw_obj();
+    bench_draw_obj_instanced();
+    bench_uniforms();
+    bench_texture_from_memory();
+    bench_shader_compile();
+
+    FILE* fp = argc>1?fopen(argv[1], "w"):stdout;
+    if(!fp){
+        fprintf(stderr, "ERROR: cannot open %s\n", argv[1]);
+        return 1;
+    }
+    bool ok = bench_write_json(fp);
+    if(fp!=stdout){
+        ok = (fclose(fp)==0) && ok;
+    }
+    return ok?0:1;
+}
@@ -0,0 +1,69 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define GRID 8
+#define MESH_COUNT (GRID*GRID)
+
+glib_arena_t* arena;
+glib_handle_t meshes[MESH_COUNT];
+glib_instance_t instances[MESH_COUNT];
+
+float quad_vertices[] = {
+    -0.5f,  0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     0.0f, 1.0f,
+     0.5f,  0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     1.0f, 1.0f,
+     0.5f, -0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     1.0f, 0.0f,
+    -0.5f, -0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     0.0f, 0.0f,
+};
+unsigned int quad_indices[] = {0, 1, 2, 0, 2, 3};
+
+float triangle_vertices[] = {
+     0.0f,  0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     0.5f, 1.0f,
+     0.5f, -0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     1.0f, 0.0f,
+    -0.5f, -0.5f, 0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     0.0f, 0.0f,
+};
+unsigned int triangle_indices[] = {0, 1, 2};
+
+glib_handle_t add_mesh(int i){
+    if(i%2==0){
+        return glib_arena_add_mesh(arena, quad_vertices, 4, quad_indices, 6);
+    }
+    return glib_arena_add_mesh(arena, triangle_vertices, 3, triangle_indices, 3);
+}
+
+void render(void){
+    // swap a mesh every second, its ranges are reused by the next add
+    if(glib_get_frame_count()%60==0){
+        int i = rand()%MESH_COUNT;
+        glib_arena_remove_mesh(arena, meshes[i]);
+        meshes[i] = add_mesh(rand());
+    }
+    glib_use_shader(glib_default_instanced_shader);
+    glib_use_texture_2d(glib_default_tex, GLIB_TEX_SLOT0);
+    glib_arena_draw(arena, meshes, instances, MESH_COUNT);
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    // small buffers, so the arena grows while the meshes are added
+    glib_vertex_layout_t layout = glib_default_vertex_layout();
+    arena = glib_create_arena(&layout, 16, 24);
+    for(int i = 0; i<MESH_COUNT; i++){
+        meshes[i] = add_mesh(i);
+        float x = -1.0f+(i%GRID+0.5f)*2.0f/GRID;
+        float y = -1.0f+(i/GRID+0.5f)*2.0f/GRID;
+        glm_mat4_identity(instances[i].model);
+        glm_translate(instances[i].model, (vec3){x, y, 0.0f});
+        glm_scale_uni(instances[i].model, 1.5f/GRID);
+        instances[i].color[0] = (float)(i%GRID)/GRID;
+        instances[i].color[1] = (float)(i/GRID)/GRID;
+        instances[i].color[2] = 1.0f;
+        instances[i].color[3] = 1.0f;
+    }
+
+    glib_main_loop();
+    return 0;
+}
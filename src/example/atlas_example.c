@@ -0,0 +1,50 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define ICON_COUNT 16
+
+glib_atlas_t* atlas;
+int icons[ICON_COUNT];
+glib_obj_t* quad_obj;
+
+void render(void){
+    // every icon lives in the same texture, so this is a single draw call
+    glib_batch_begin();
+    for(int i = 0; i<ICON_COUNT; i++){
+        glib_atlas_region_t region = glib_atlas_get_region(atlas, icons[i]);
+        glib_batch_set_texture(region.texture);
+        glib_batch_push_rect(-0.9f+(i%8)*0.22f, 0.1f+(i/8)*0.4f, 0.2f, 0.2f, region.u0, region.v0, region.u1, region.v1, 0xFFFFFFFF);
+    }
+    glib_batch_end();
+
+    glib_use_texture_2d(glib_atlas_get_region(atlas, icons[0]).texture, GLIB_TEX_SLOT0);
+    glib_draw_obj(quad_obj);
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    atlas = glib_create_atlas(1024, 1024, 4);
+    icons[0] = glib_atlas_add_image(atlas, "./resources/textures/wall.jpg");
+    for(int i = 1; i<ICON_COUNT; i++){
+        // small generated icons with a different color each
+        unsigned char pixels[32*32*4];
+        for(int p = 0; p<32*32; p++){
+            pixels[p*4+0] = i*16;
+            pixels[p*4+1] = 255-i*16;
+            pixels[p*4+2] = ((p%32)^(p/32))*8;
+            pixels[p*4+3] = 255;
+        }
+        icons[i] = glib_atlas_add_image_from_memory(atlas, pixels, 32, 32);
+    }
+    glib_atlas_build(atlas);
+
+    quad_obj = glib_create_quad_obj(-0.5f, -0.1f, 0.5f, -0.1f, 0.5f, -0.9f, -0.5f, -0.9f);
+    glib_set_obj_uv_region(quad_obj, glib_atlas_get_region(atlas, icons[0]));
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,35 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define GRID 140
+
+unsigned int texture;
+
+void render(void){
+    float size = 2.0f/GRID;
+
+    glib_batch_begin();
+    for(int y = 0; y<GRID; y++){
+        // the texture switch in the middle breaks the batch into two draw calls
+        if(y==GRID/2){
+            glib_batch_set_texture(texture);
+        }
+        for(int x = 0; x<GRID; x++){
+            int color = ((x*255/GRID)<<24) | ((y*255/GRID)<<16) | 0x80FF;
+            glib_batch_push_rect(-1.0f+x*size, -1.0f+y*size, size*0.9f, size*0.9f, 0.0f, 0.0f, 1.0f, 1.0f, color);
+        }
+    }
+    glib_batch_end();
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    texture = glib_load_texture_2d("./resources/textures/wall.jpg", 0);
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,35 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+glib_obj_t* model_obj;
+glib_camera_t camera;
+
+void render(void){
+    glib_use_texture_2d(glib_default_tex, GLIB_TEX_SLOT0);
+    glib_draw_obj(model_obj);
+}
+
+int main(int argc, char** argv){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    // pass a multi gigabyte scan as the first argument
+    const char* file_path = argc>1?argv[1]:"./resources/models/cube.obj";
+    double start = glfwGetTime();
+    model_obj = glib_load_obj_parallel(file_path);
+    printf("%s: %u vertices, %u triangles in %.2f s\n", file_path, model_obj->vertex_count, model_obj->index_len/3, glfwGetTime()-start);
+
+    // look at the whole model
+    vec3 center, extent;
+    glm_vec3_add(model_obj->bounds_min, model_obj->bounds_max, center);
+    glm_vec3_scale(center, 0.5f, center);
+    glm_vec3_sub(model_obj->bounds_max, model_obj->bounds_min, extent);
+    camera = glib_create_camera((vec3){center[0], center[1], center[2]+glm_vec3_norm(extent)*1.5f+1.0f});
+    glib_camera_set_clip(&camera, 0.01f, glm_vec3_norm(extent)*10.0f+100.0f);
+    glib_use_camera(&camera);
+
+    glib_main_loop();
+    return 0;
+}
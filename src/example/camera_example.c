@@ -0,0 +1,58 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define GRID 100
+
+glib_obj_t* quad_obj;
+glib_camera_t camera;
+glib_scene_t* scene;
+double last_x, last_y;
+
+void update(double dt){
+    if(glib_is_keboard_pressed(GLIB_KEY_W)) glib_camera_move(&camera, GLIB_CAMERA_FORWARD, (float)dt);
+    if(glib_is_keboard_pressed(GLIB_KEY_S)) glib_camera_move(&camera, GLIB_CAMERA_BACKWARD, (float)dt);
+    if(glib_is_keboard_pressed(GLIB_KEY_A)) glib_camera_move(&camera, GLIB_CAMERA_LEFT, (float)dt);
+    if(glib_is_keboard_pressed(GLIB_KEY_D)) glib_camera_move(&camera, GLIB_CAMERA_RIGHT, (float)dt);
+
+    // look around while the left button is held
+    double x = glib_get_mouse_pos_x(), y = glib_get_mouse_pos_y();
+    if(glib_is_mouse_pressed(GLIB_MOUSE_BUTTON_LEFT)){
+        glib_camera_rotate(&camera, (float)(x-last_x), (float)(last_y-y));
+    }
+    last_x = x;
+    last_y = y;
+}
+
+void render(void){
+    // only the quads in the view reach the render queue
+    unsigned int visible = glib_scene_submit(scene, &camera);
+    if(glib_get_frame_count()%120==0){
+        printf("visible: %u of %d\n", visible, GRID*GRID);
+    }
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_update_callback(update);
+    glib_set_render_callback(render);
+
+    quad_obj = glib_create_quad_obj(-0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f);
+    scene = glib_create_scene();
+    for(int z = 0; z<GRID; z++){
+        for(int x = 0; x<GRID; x++){
+            mat4 model;
+            glm_mat4_identity(model);
+            glm_translate(model, (vec3){(x-GRID/2)*2.0f, 0.0f, -z*2.0f});
+            glib_draw_t draw = glib_make_draw(quad_obj, glib_default_shader, glib_default_tex);
+            glib_scene_add(scene, &draw, model);
+        }
+    }
+
+    camera = glib_create_camera((vec3){0.0f, 0.5f, 3.0f});
+    glib_use_camera(&camera);
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,45 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+glib_obj_t* quad_obj;
+glib_uniform_handle_t model_uniform;
+
+// the simulation state of the last two updates
+float prev_x, x;
+float velocity = 0.8f;
+
+void update(double dt){
+    prev_x = x;
+    x += velocity*(float)dt;
+    if(x>0.8f || x<-0.8f){
+        velocity = -velocity;
+    }
+}
+
+void render(void){
+    float alpha = (float)glib_get_frame_alpha();
+    float draw_x = prev_x+(x-prev_x)*alpha;
+
+    mat4 model;
+    glm_mat4_identity(model);
+    glm_translate(model, (vec3){draw_x, 0.0f, 0.0f});
+    glib_set_uniform_mat4_handle(model_uniform, model);
+    glib_draw_obj(quad_obj);
+}
+
+int main(){
+    glib_init();
+    glib_set_vsync(0);
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_update_callback(update);
+    glib_set_fixed_timestep(1.0/30.0);
+    glib_set_target_fps(144.0);
+    glib_set_render_callback(render);
+
+    quad_obj = glib_create_quad_obj(-0.2f, 0.2f, 0.2f, 0.2f, 0.2f, -0.2f, -0.2f, -0.2f);
+    model_uniform = glib_get_uniform(glib_default_shader, "model");
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,46 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define FRAMES 60
+
+glib_obj_t* triangle_obj;
+
+void render(void){
+    mat4 model;
+    glm_mat4_identity(model);
+    glm_rotate_z(model, (float)glib_get_frame_count()*0.1f, model);
+    glib_set_unifrom_mat4(glib_default_shader, "model", model);
+    glib_draw_obj(triangle_obj);
+}
+
+// the last frame is saved as a PPM image, the rows arrive from the bottom up
+void readback(const unsigned char* pixels, int width, int height, unsigned long long frame){
+    if(frame!=FRAMES-1){
+        return;
+    }
+    FILE* fp = fopen("frame.ppm", "wb");
+    if(!fp){
+        return;
+    }
+    fprintf(fp, "P6\n%d %d\n255\n", width, height);
+    for(int y = height-1; y>=0; y--){
+        for(int x = 0; x<width; x++){
+            fwrite(&pixels[(y*width+x)*4], 1, 3, fp);
+        }
+    }
+    fclose(fp);
+}
+
+int main(){
+    glib_init();
+    glib_create_headless(640, 480);
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+    glib_set_readback_callback(readback);
+    glib_set_frame_limit(FRAMES);
+
+    triangle_obj = glib_create_triangle_obj(-0.5f, -0.5f, 0.5f, -0.5f, 0.0f, 0.5f);
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,42 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+glib_obj_t* quad_obj;
+glib_input_event_t events[GLIB_INPUT_QUEUE_SIZE];
+bool wired = false;
+
+void render(void){
+    // a tap shorter than a frame still toggles
+    if(glib_was_key_pressed(GLIB_KEY_SPACE)){
+        wired = !wired;
+    }
+
+    unsigned int count = glib_drain_input_events(events, GLIB_ARRAY_LEN(events));
+    for(unsigned int i = 0; i<count; i++){
+        glib_input_event_t* event = &events[i];
+        if(event->type==GLIB_INPUT_KEY){
+            printf("%.4f key %d %s\n", event->time, event->code, event->action==GLIB_INPUT_PRESS?"press":event->action==GLIB_INPUT_RELEASE?"release":"repeat");
+        }else if(event->type==GLIB_INPUT_MOUSE_BUTTON){
+            printf("%.4f mouse button %d %s at %.0f %.0f\n", event->time, event->code, event->action==GLIB_INPUT_PRESS?"press":"release", event->x, event->y);
+        }
+    }
+
+    if(wired){
+        glib_wired_draw();
+    }else{
+        glib_filled_draw();
+    }
+    glib_draw_obj(quad_obj);
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    quad_obj = glib_create_quad_obj_ex(-0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0x6666BBFF);
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,40 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define GRID 200
+
+glib_obj_t* quad_obj;
+glib_instance_t instances[GRID*GRID];
+
+void render(void){
+    float size = 2.0f/GRID;
+    float time = (float)glfwGetTime();
+
+    for(int y = 0; y<GRID; y++){
+        for(int x = 0; x<GRID; x++){
+            glib_instance_t* instance = &instances[y*GRID+x];
+            glm_mat4_identity(instance->model);
+            glm_translate(instance->model, (vec3){-1.0f+(x+0.5f)*size, -1.0f+(y+0.5f)*size, 0.0f});
+            glm_rotate_z(instance->model, time+(x+y)*0.05f, instance->model);
+            glm_scale_uni(instance->model, size*0.4f);
+            glm_vec4_copy((vec4){(float)x/GRID, (float)y/GRID, 1.0f, 1.0f}, instance->color);
+        }
+    }
+
+    // one draw call for every quad
+    glib_use_shader(glib_get_default_instanced_shader());
+    glib_set_obj_instances(quad_obj, instances, GRID*GRID);
+    glib_draw_obj_instanced(quad_obj, GRID*GRID);
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    quad_obj = glib_create_quad_obj(-1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f);
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,53 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define QUADS 64
+
+glib_handle_t quads[QUADS];
+unsigned int wall_tex;
+
+void load_level(void){
+    wall_tex = glib_load_texture_2d("./resources/textures/wall.jpg", 0);
+    for(int i = 0; i<QUADS; i++){
+        float x = -1.0f+(i%8)*0.25f, y = -1.0f+(i/8)*0.25f;
+        quads[i] = glib_obj_handle(glib_create_quad_obj(x, y+0.2f, x+0.2f, y+0.2f, x+0.2f, y, x, y));
+    }
+}
+
+void render(void){
+    // R unloads everything and loads it again, the old buffers are deleted when the GPU is done with them
+    if(glib_was_key_pressed(GLIB_KEY_R)){
+        glib_destroy_all();
+        load_level();
+    }
+    // D destroys the quads one by one, the handles of the destroyed ones resolve to NULL
+    if(glib_was_key_pressed(GLIB_KEY_D)){
+        for(int i = 0; i<QUADS; i++){
+            glib_obj_t* obj = glib_get_obj(quads[i]);
+            if(obj){
+                glib_destroy_obj(obj);
+                break;
+            }
+        }
+    }
+
+    glib_use_texture_2d(wall_tex, GLIB_TEX_SLOT0);
+    for(int i = 0; i<QUADS; i++){
+        glib_obj_t* obj = glib_get_obj(quads[i]);
+        if(obj){
+            glib_draw_obj(obj);
+        }
+    }
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    load_level();
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,46 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+glib_obj_t* model_obj;
+glib_camera_t camera;
+glib_scene_t* scene;
+
+void render(void){
+    // the scene selects the LOD of every copy from its size on the screen
+    glib_scene_submit(scene, &camera);
+}
+
+int main(int argc, char** argv){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+    glib_wired_draw();
+
+    const char* file_path = argc>1?argv[1]:"./resources/models/cube.obj";
+    model_obj = glib_load_obj(file_path);
+    unsigned int lod_count = glib_build_obj_lods(model_obj, GLIB_MAX_LODS);
+    for(unsigned int i = 0; i<lod_count; i++){
+        printf("LOD %u: %u triangles, error %f\n", i, model_obj->lods[i].index_count/3, model_obj->lods[i].error);
+    }
+
+    // a row of copies which go away from the camera
+    vec3 extent;
+    glm_vec3_sub(model_obj->bounds_max, model_obj->bounds_min, extent);
+    float size = glm_vec3_norm(extent)+0.01f;
+    scene = glib_create_scene();
+    glib_draw_t draw = glib_make_draw(model_obj, glib_default_shader, glib_default_tex);
+    for(int i = 0; i<64; i++){
+        mat4 model;
+        glm_mat4_identity(model);
+        glm_translate(model, (vec3){0.0f, 0.0f, -size*1.5f*i*i*0.25f});
+        glib_scene_add(scene, &draw, model);
+    }
+
+    camera = glib_create_camera((vec3){size, size*0.5f, size*2.0f});
+    glib_camera_set_clip(&camera, 0.01f, size*2000.0f);
+    glib_use_camera(&camera);
+
+    glib_main_loop();
+    return 0;
+}
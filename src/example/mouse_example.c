@@ -3,6 +3,7 @@
 
 glib_obj_t* quad_obj;
 unsigned int my_shader;
+glib_uniform_handle_t time_uniform, mouse_x_uniform, mouse_y_uniform;
 
 float mouse_x,mouse_y;
 
@@ -12,11 +13,11 @@ void render(void){
     mouse_y = glib_get_mouse_pos_y();
 
     glib_use_shader(my_shader);
-    glib_set_uniform1f(my_shader, "time", (float)glfwGetTime());
+    glib_set_uniform1f_handle(time_uniform, (float)glfwGetTime());
 
     if(glib_is_mouse_pressed(GLIB_MOUSE_BUTTON_LEFT)){
-        glib_set_uniform1f(my_shader, "mouse_x", mouse_x);
-        glib_set_uniform1f(my_shader, "mouse_y", mouse_y);
+        glib_set_uniform1f_handle(mouse_x_uniform, mouse_x);
+        glib_set_uniform1f_handle(mouse_y_uniform, mouse_y);
 
     }
     
@@ -29,9 +30,12 @@ int main(){
     glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
     glib_set_render_callback(render);
     my_shader = glib_create_shader("./resources/shaders/mouse_example/main.vert", "./resources/shaders/mouse_example/main.frag");
+    time_uniform = glib_get_uniform(my_shader, "time");
+    mouse_x_uniform = glib_get_uniform(my_shader, "mouse_x");
+    mouse_y_uniform = glib_get_uniform(my_shader, "mouse_y");
 
     quad_obj = glib_create_quad_obj_ex(-0.5f,  0.5f, 0.5f, 0.5f, 0.5f,-0.5f, -0.5f,-0.5f, 0x6666BBFF);
 
     glib_main_loop();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+glib_obj_t* cube_obj;
+unsigned int texture;
+
+void render(void){
+    glib_use_texture_2d(texture, GLIB_TEX_SLOT0);
+    glib_draw_obj(cube_obj);
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    // usually the pack is made by the build, the loaders find the files by the same paths.
+    // Loading the files once writes their caches, the pack takes them too so nothing is decoded or parsed from it
+    const char* assets[] = {
+        "./resources/models/cube.obj",
+        "./resources/textures/wall.jpg",
+    };
+    glib_destroy_obj(glib_load_obj(assets[0]));
+    glib_destroy_texture(glib_load_texture_2d(assets[1], 0));
+    if(!glib_write_pack("./assets.glibpack", assets, GLIB_ARRAY_LEN(assets)) || !glib_mount_pack("./assets.glibpack")){
+        fprintf(stderr, "[WARN] The assets are loaded from the files\n");
+    }
+
+    texture = glib_load_texture_2d("./resources/textures/wall.jpg", 0);
+    cube_obj = glib_load_obj("./resources/models/cube.obj");
+
+    glib_main_loop();
+    glib_unmount_packs();
+    return 0;
+}
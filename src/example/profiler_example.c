@@ -0,0 +1,28 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+glib_obj_t* quad_obj;
+
+void render(void){
+    glib_profile_scope_t scope = glib_profile_begin("draw quads", true);
+    for(int i = 0; i<100; i++){
+        glib_draw_obj(quad_obj);
+    }
+    glib_profile_end(scope);
+}
+
+int main(){
+    glib_init();
+    glib_profiler_enable(true);
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    quad_obj = glib_create_quad_obj(-0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f);
+
+    glib_main_loop();
+
+    // open it in chrome://tracing or https://ui.perfetto.dev
+    glib_profiler_write_trace("trace.json");
+    return 0;
+}
@@ -0,0 +1,66 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define GRID 40
+#define OVERLAYS 6
+
+glib_obj_t* quad_obj;
+glib_obj_t* overlay_obj;
+unsigned int wall_tex;
+glib_uniform_handle_t model_uniform;
+unsigned int cell_textures[GRID*GRID];
+
+void render(void){
+    float size = 2.0f/GRID;
+    float time = (float)glfwGetTime();
+    mat4 model;
+
+    // the cells are submitted in grid order, the queue groups them by texture
+    for(int y = 0; y<GRID; y++){
+        for(int x = 0; x<GRID; x++){
+            glib_draw_t draw = glib_make_draw(quad_obj, glib_default_shader, cell_textures[y*GRID+x]);
+            glm_mat4_identity(model);
+            glm_translate(model, (vec3){-1.0f+(x+0.5f)*size, -1.0f+(y+0.5f)*size, 0.0f});
+            glm_scale_uni(model, size*0.45f);
+            glib_draw_set_uniform_mat4(&draw, model_uniform, model);
+            glib_submit_draw(&draw);
+        }
+    }
+
+    // the transparent quads are drawn after the opaque ones, the farthest first
+    for(int i = 0; i<OVERLAYS; i++){
+        glib_draw_t draw = glib_make_draw(overlay_obj, glib_default_shader, glib_default_tex);
+        glm_mat4_identity(model);
+        glm_translate(model, (vec3){cosf(time+i)*0.5f, sinf(time+i)*0.5f, 0.0f});
+        glm_scale_uni(model, 0.3f);
+        glib_draw_set_uniform_mat4(&draw, model_uniform, model);
+        draw.transparent = true;
+        draw.depth = (float)i;
+        glib_submit_draw(&draw);
+    }
+
+    if(glib_get_frame_count()%120==0){
+        glib_state_stats_t stats = glib_get_state_stats();
+        printf("state changes issued: %llu, skipped: %llu\n", stats.issued, stats.skipped);
+        glib_reset_state_stats();
+    }
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    quad_obj = glib_create_quad_obj(-1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f);
+    overlay_obj = glib_create_quad_obj_ex(-1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 0xFF804080);
+    wall_tex = glib_load_texture_2d("./resources/textures/wall.jpg", 0);
+    model_uniform = glib_get_uniform(glib_default_shader, "model");
+
+    for(int i = 0; i<GRID*GRID; i++){
+        cell_textures[i] = rand()%2?wall_tex:glib_default_tex;
+    }
+
+    glib_main_loop();
+    return 0;
+}
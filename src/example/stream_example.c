@@ -0,0 +1,56 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define SEGMENTS 256
+
+glib_obj_t* wave_obj;
+float vertices[(SEGMENTS+1)*2*GLIB_VERTEX_FLOAT_COUNT];
+unsigned int indices[SEGMENTS*6];
+
+void update_wave(float time){
+    for(int i = 0; i<=SEGMENTS; i++){
+        float x = -1.0f+2.0f*i/SEGMENTS;
+        float y = 0.3f*sinf(x*6.0f+time);
+        for(int side = 0; side<2; side++){
+            float* v = &vertices[(i*2+side)*GLIB_VERTEX_FLOAT_COUNT];
+            v[0] = x;
+            v[1] = side?y+0.1f:y-0.1f;
+            v[2] = 0.0f;
+            v[3] = 0.5f+0.5f*sinf(time+x);
+            v[4] = 0.8f;
+            v[5] = 1.0f;
+            v[6] = 1.0f;
+            v[7] = (float)i/SEGMENTS;
+            v[8] = (float)side;
+        }
+    }
+}
+
+void render(void){
+    // the stream object writes a free copy of its vertex buffer, so this never waits for the GPU
+    update_wave((float)glfwGetTime());
+    glib_update_obj_vertices(wave_obj, vertices, GLIB_ARRAY_LEN(vertices));
+    glib_draw_obj(wave_obj);
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    for(int i = 0; i<SEGMENTS; i++){
+        unsigned int* quad = &indices[i*6];
+        quad[0] = i*2;
+        quad[1] = i*2+1;
+        quad[2] = i*2+3;
+        quad[3] = i*2;
+        quad[4] = i*2+3;
+        quad[5] = i*2+2;
+    }
+    update_wave(0.0f);
+    wave_obj = glib_create_obj_with_usage(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices), GLIB_BUFFER_STREAM);
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,35 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+#define LABELS 2000
+
+glib_font_t* font;
+
+void render(void){
+    // the static labels come from the layout cache, only the changing numbers are laid out again
+    char text[64];
+    for(int i = 0; i<LABELS; i++){
+        snprintf(text, sizeof(text), "sensor %d: %d", i, (int)(glib_get_time()*10.0)%(i+1));
+        glib_draw_text(font, text, 10.0f+(i%10)*88.0f, 10.0f+(i/10)*2.8f, 10.0f, 0xFFFFFFFF);
+    }
+
+    // the same glyphs stay sharp at any size
+    const char* title = "GLib text";
+    float size = 60.0f+40.0f*sinf((float)glib_get_time());
+    float width, height;
+    glib_measure_text(font, title, size, &width, &height);
+    glib_draw_text(font, title, (glib_window_width-width)*0.5f, glib_window_height-height, size, 0xFFCC00FF);
+}
+
+int main(int argc, char** argv){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    // Lato is under the SIL Open Font License, see resources/fonts/OFL.txt
+    font = glib_load_font(argc>1?argv[1]:"./resources/fonts/Lato-Regular.ttf");
+
+    glib_main_loop();
+    return 0;
+}
@@ -0,0 +1,51 @@
+#define GLIB_IMPLEMENTATION
+#include "../glib.h"
+
+// matches glib_compact_vertex_layout: 20 bytes instead of the 36 bytes of the default layout
+typedef struct {
+    float pos[3];
+    unsigned char col[4];
+    unsigned short uv[2];
+} compact_vertex_t;
+
+glib_obj_t* quad_obj;
+unsigned int texture;
+
+void render(void){
+    glib_use_texture_2d(texture, GLIB_TEX_SLOT0);
+    glib_draw_obj(quad_obj);
+}
+
+compact_vertex_t make_vertex(float x, float y, unsigned int color, float u, float v){
+    compact_vertex_t vertex = {
+        .pos = {x, y, 0.0f},
+        .col = {(color>>24)&0xFF, (color>>16)&0xFF, (color>>8)&0xFF, color&0xFF},
+        .uv = {glib_float_to_half(u), glib_float_to_half(v)},
+    };
+    return vertex;
+}
+
+int main(){
+    glib_init();
+    glib_create_window(900, 600, "GLib window");
+    glib_clear_color(0.0f, 0.3f, 1.0f, 1.0f);
+    glib_set_render_callback(render);
+
+    texture = glib_load_texture_2d("./resources/textures/wall.jpg", 0);
+
+    compact_vertex_t vertices[] = {
+        make_vertex(-0.5f,  0.5f, 0xFF0000FF, 0.0f, 1.0f),
+        make_vertex( 0.5f,  0.5f, 0x00FF00FF, 1.0f, 1.0f),
+        make_vertex( 0.5f, -0.5f, 0x0000FFFF, 1.0f, 0.0f),
+        make_vertex(-0.5f, -0.5f, 0xFFFFFFFF, 0.0f, 0.0f),
+    };
+    unsigned short indices[] = {
+        0, 1, 2,
+        0, 2, 3
+    };
+    glib_vertex_layout_t layout = glib_compact_vertex_layout();
+    quad_obj = glib_create_obj_with_layout(vertices, GLIB_ARRAY_LEN(vertices), &layout, indices, GLIB_ARRAY_LEN(indices), GLIB_INDEX_UINT16, GLIB_BUFFER_STATIC);
+
+    glib_main_loop();
+    return 0;
+}
@@ -36,6 +36,24 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <math.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include <gl/glew.h>
 #include <GLFW/glfw3.h>
@@ -43,6 +61,9 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb/stb_truetype.h>
+
 #include <cglm/cglm.h>
 
 #define FAST_OBJ_IMPLEMENTATION
@@ -55,9 +76,153 @@ extern "C" {
 #define GLIB_ARRAY_LEN(ARR) (sizeof(ARR)/sizeof(ARR[0]))
 #define GLIB_HEX_TO_RGBA_F(H) ((H>>24)&0xFF)/255.0f, ((H>>16)&0xFF)/255.0f, ((H>>8)&0xFF)/255.0f, ((H>>0)&0xFF)/255.0f
 
-#define GLIB_SUPPORTED_VERTICES  30000
-#define GLIB_SUPPORTED_UVS       30000
-#define GLIB_SUPPORTED_NORMALS   30000
+// pos(3) + color(4) + uv(2)
+#define GLIB_VERTEX_FLOAT_COUNT 9
+
+// Quads in one batch flush, the stream buffer holds GLIB_BATCH_STREAM_FACTOR flushes before orphaning
+#ifndef GLIB_BATCH_MAX_QUADS
+#define GLIB_BATCH_MAX_QUADS 16384
+#endif
+#define GLIB_BATCH_STREAM_FACTOR 4
+
+// Width and height of a font atlas texture
+#ifndef GLIB_FONT_ATLAS_SIZE
+#define GLIB_FONT_ATLAS_SIZE 1024
+#endif
+// Glyphs are rendered into the distance fields at this pixel height, with GLIB_FONT_SDF_PADDING pixels of distance around them
+#ifndef GLIB_FONT_SDF_SIZE
+#define GLIB_FONT_SDF_SIZE 48
+#endif
+#ifndef GLIB_FONT_SDF_PADDING
+#define GLIB_FONT_SDF_PADDING 6
+#endif
+// Initial size of the layout cache of a font, a power of two
+#ifndef GLIB_TEXT_CACHE_SIZE
+#define GLIB_TEXT_CACHE_SIZE 1024
+#endif
+
+// Vertex attribute locations of the per instance data, the mat4 takes 4 locations
+#define GLIB_INSTANCE_MODEL_LOCATION 3
+#define GLIB_INSTANCE_COLOR_LOCATION 7
+
+// Copies of the vertices of a dynamic or stream object, the CPU writes one while the GPU reads the others
+#define GLIB_BUFFER_RING_SIZE 3
+
+#define GLIB_MAX_VERTEX_ATTRIBS 8
+
+// Items in one page of the object, shader and texture pools
+#ifndef GLIB_POOL_PAGE_SIZE
+#define GLIB_POOL_PAGE_SIZE 256
+#endif
+// Frames which can wait for the deletion of destroyed GL resources, see glib_collect_garbage
+#define GLIB_GARBAGE_BATCHES 4
+
+#define GLIB_UNIFORM_NAME_LEN 64
+
+// Texture slots and uniform values of a queued draw, see glib_submit_draw
+#ifndef GLIB_DRAW_TEXTURES
+#define GLIB_DRAW_TEXTURES 4
+#endif
+#ifndef GLIB_DRAW_UNIFORMS
+#define GLIB_DRAW_UNIFORMS 4
+#endif
+
+// Scene draws in one leaf of the culling BVH
+#ifndef GLIB_BVH_LEAF_SIZE
+#define GLIB_BVH_LEAF_SIZE 4
+#endif
+
+// glib_load_obj keeps a binary copy of the parsed model next to the OBJ file with this extension
+#ifndef GLIB_MESH_CACHE_EXT
+#define GLIB_MESH_CACHE_EXT ".glibmesh"
+#endif
+#define GLIB_MESH_MAGIC 0x4D424C47u // "GLBM"
+#define GLIB_MESH_VERSION 1
+
+// glib_load_texture_2d keeps the decoded image and its mip chain next to the image file with this extension
+#ifndef GLIB_TEXTURE_CACHE_EXT
+#define GLIB_TEXTURE_CACHE_EXT ".glibtex"
+#endif
+#define GLIB_TEXTURE_MAGIC 0x54424C47u // "GLBT"
+#define GLIB_TEXTURE_VERSION 1
+
+// Linked shader programs are cached in this directory as driver specific binaries (see glib_set_shader_cache_dir)
+#ifndef GLIB_SHADER_CACHE_DIR
+#define GLIB_SHADER_CACHE_DIR "shader_cache"
+#endif
+#define GLIB_PROGRAM_CACHE_EXT ".glibprog"
+#define GLIB_PROGRAM_MAGIC 0x50424C47u // "GLBP"
+#define GLIB_PROGRAM_VERSION 1
+
+// glib_write_pack aligns every packed file to this many bytes, it has to be a power of two
+#ifndef GLIB_PACK_ALIGNMENT
+#define GLIB_PACK_ALIGNMENT 64
+#endif
+#define GLIB_PACK_MAGIC 0x4B504C47u // "GLPK"
+#define GLIB_PACK_VERSION 1
+
+// Packs mounted at once, see glib_mount_pack
+#ifndef GLIB_MAX_PACKS
+#define GLIB_MAX_PACKS 8
+#endif
+
+// Parser threads of glib_load_obj_parallel
+#ifndef GLIB_OBJ_THREADS
+#define GLIB_OBJ_THREADS 8
+#endif
+
+// glib_load_obj_parallel uploads the model in batches of this many vertices
+#ifndef GLIB_OBJ_BATCH_VERTICES
+#define GLIB_OBJ_BATCH_VERTICES 65536
+#endif
+
+// Levels of the LOD chain of an object with the full mesh, see glib_build_obj_lods
+#ifndef GLIB_MAX_LODS
+#define GLIB_MAX_LODS 4
+#endif
+// Triangles of a LOD relative to the previous one
+#ifndef GLIB_LOD_RATIO
+#define GLIB_LOD_RATIO 0.5f
+#endif
+// Screen space error in pixels which a LOD may have
+#ifndef GLIB_LOD_PIXEL_ERROR
+#define GLIB_LOD_PIXEL_ERROR 1.0f
+#endif
+// Relative margin around GLIB_LOD_PIXEL_ERROR before the LOD changes
+#ifndef GLIB_LOD_HYSTERESIS
+#define GLIB_LOD_HYSTERESIS 0.25f
+#endif
+
+// Decoder threads of the async texture loader
+#ifndef GLIB_TEXTURE_WORKERS
+#define GLIB_TEXTURE_WORKERS 4
+#endif
+// Default time in seconds which glib_main_loop spends with texture uploads in a frame
+#ifndef GLIB_TEXTURE_UPLOAD_BUDGET
+#define GLIB_TEXTURE_UPLOAD_BUDGET 0.002
+#endif
+
+// Default step of the update callback in seconds, see glib_set_fixed_timestep
+#ifndef GLIB_FIXED_TIMESTEP
+#define GLIB_FIXED_TIMESTEP (1.0/60.0)
+#endif
+// Longer frames are counted as this long by the fixed timestep loop
+#define GLIB_MAX_FRAME_DELTA 0.25
+
+// Profiler events kept in the ring buffer, it has to be a power of 2
+#ifndef GLIB_PROFILER_CAPACITY
+#define GLIB_PROFILER_CAPACITY 65536
+#endif
+// GPU scopes which can wait for their result at the same time, a scope takes two timestamp queries
+#define GLIB_PROFILER_GPU_QUERIES 64
+
+// Pixel pack buffers of the frame readback, a frame is handed to the readback callback this many frames later at most
+#define GLIB_READBACK_BUFFERS 3
+
+// Input events which can come in one frame, it has to be a power of 2
+#ifndef GLIB_INPUT_QUEUE_SIZE
+#define GLIB_INPUT_QUEUE_SIZE 1024
+#endif
 
 #define GLIB_MAX_KEYBOARD_KEY_SUPPORTED 350
 #define GLIB_MAX_MOUSE_BUTTON_SUPPORTED 8
@@ -190,18 +355,118 @@ extern "C" {
 #define 	GLIB_KEY_MENU   348
 #define 	GLIB_KEY_LAST   GLIB_KEY_MENU
 
+/*!
+    @brief The usage of the buffers of an object. Dynamic and stream objects keep GLIB_BUFFER_RING_SIZE copies of the vertices, so an update never waits for the GPU
+*/
+typedef enum {
+    GLIB_BUFFER_STATIC = 0, // uploaded once, updates may wait for the GPU
+    GLIB_BUFFER_DYNAMIC,    // updated sometimes
+    GLIB_BUFFER_STREAM,     // updated every frame
+} glib_buffer_usage;
+
+/*!
+    @brief The component types of a vertex attribute
+*/
+typedef enum {
+    GLIB_ATTRIB_FLOAT = 0,
+    GLIB_ATTRIB_HALF_FLOAT,     // see glib_float_to_half
+    GLIB_ATTRIB_BYTE,
+    GLIB_ATTRIB_UNSIGNED_BYTE,
+    GLIB_ATTRIB_SHORT,
+    GLIB_ATTRIB_UNSIGNED_SHORT,
+} glib_attrib_type;
+
+/*!
+    @brief One attribute of a vertex layout
+*/
+typedef struct {
+    unsigned int location;  // the layout location in the vertex shader
+    int size;               // number of components, 1-4
+    glib_attrib_type type;
+    bool normalized;        // integer components are mapped to [0, 1] or [-1, 1]
+    unsigned int offset;    // bytes from the start of the vertex
+} glib_vertex_attrib_t;
+
+/*!
+    @brief The memory layout of the vertices of an object. The default layout (see glib_default_vertex_layout) is 3 float position, 4 float color and 2 float uv
+*/
+typedef struct {
+    glib_vertex_attrib_t attribs[GLIB_MAX_VERTEX_ATTRIBS];
+    unsigned int attrib_count;
+    unsigned int stride;    // bytes of one vertex
+} glib_vertex_layout_t;
+
+/*!
+    @brief The type of the indices of an object
+*/
+typedef enum {
+    GLIB_INDEX_UINT32 = 0,
+    GLIB_INDEX_UINT16,
+} glib_index_type;
+
+/*!
+    @brief Generation checked handle of a pooled object, shader or texture. A handle of a destroyed resource never resolves again
+*/
+typedef unsigned long long glib_handle_t;
+#define GLIB_INVALID_HANDLE 0ull
+
+/*!
+    @brief A level of the LOD chain of an object, see glib_build_obj_lods
+*/
+typedef struct {
+    unsigned int first_index;   // in the index buffer of the object
+    unsigned int index_count;
+    float error;                // the maximum distance of the simplified surface from the full mesh in object space
+} glib_obj_lod_t;
+
 /*!
     @breif this struct stores some data for a whole object and used in renderering that
 */
 typedef struct {
-    float* vertices;
-    unsigned int vertex_len;
-    unsigned int* indices;
+    float* vertices;            // the vertex data, it is only an array of floats with the default layout
+    unsigned int vertex_len;    // the size of the vertex data in floats
+    unsigned int* indices;      // the index data, it is an array of unsigned short with 16 bit indices
     unsigned int index_len;
+    bool owns_vertices;         // the arrays are freed with the object
+    bool owns_indices;
+    glib_handle_t handle;
 
     int VBO, EBO, VAO;
+
+    glib_vertex_layout_t layout;
+    glib_index_type index_type;
+    unsigned int vertex_count;
+
+    // object space bounding box of the positions (the attribute at location 0), used by the frustum culling
+    vec3 bounds_min;
+    vec3 bounds_max;
+
+    // per instance attributes, see glib_set_obj_instances
+    unsigned int instance_VBO;
+    unsigned int instance_count;
+    unsigned int instance_capacity;
+
+    // buffer updates, see glib_update_obj_vertices
+    glib_buffer_usage usage;
+    unsigned int vertex_capacity; // vertices in one region of the vertex buffer
+    unsigned int index_capacity;
+    unsigned int ring_index;      // the region which is drawn
+    GLsync fences[GLIB_BUFFER_RING_SIZE];
+
+    // LOD chain, lod_count is 0 without one, see glib_build_obj_lods
+    glib_obj_lod_t lods[GLIB_MAX_LODS];
+    unsigned int lod_count;
+    unsigned int lod;             // the LOD which glib_draw_obj draws
 } glib_obj_t;
 
+/*!
+    @brief Per instance data of glib_draw_obj_instanced, the default instanced shader multiplies the model uniform with the model matrix and the vertex color with the color
+*/
+typedef struct {
+    mat4 model;
+    vec4 color;
+} glib_instance_t;
+
 
 /*!
     @brief This enum contains the currently available texture slots. The slot 0 is the default texture slot which is used by default
@@ -228,6 +493,104 @@ typedef enum {
     GLIB_TEX_SLOT_COUNT,
 } glib_texture_slot;
 
+
+/*!
+    @brief Handle of a texture which is loaded in the background, see glib_load_texture_2d_async
+*/
+typedef unsigned int glib_async_texture_t;
+
+/*!
+    @brief The loading states of an async texture
+*/
+typedef enum {
+    GLIB_TEXTURE_QUEUED = 0,
+    GLIB_TEXTURE_DECODED,
+    GLIB_TEXTURE_READY,
+    GLIB_TEXTURE_FAILED,
+} glib_texture_state;
+
+/*!
+    @brief A packed image in a texture atlas: the atlas texture and the uv rectangle of the image in it
+*/
+typedef struct {
+    unsigned int texture;
+    float u0, v0;   // bottom left
+    float u1, v1;   // top right
+} glib_atlas_region_t;
+
+/*!
+    @brief Texture atlas builder, see glib_create_atlas
+*/
+typedef struct glib_atlas_t glib_atlas_t;
+
+/*!
+    @brief TrueType font with its glyph atlas, see glib_load_font
+*/
+typedef struct glib_font_t glib_font_t;
+
+/*!
+    @brief Handle to an active uniform of a shader program, see glib_get_uniform
+*/
+typedef struct {
+    unsigned int program;
+    int index;
+} glib_uniform_handle_t;
+
+/*!
+    @brief The types of the uniform values of a queued draw
+*/
+typedef enum {
+    GLIB_UNIFORM_INT = 0,
+    GLIB_UNIFORM_FLOAT,
+    GLIB_UNIFORM_DOUBLE,
+    GLIB_UNIFORM_MAT4,
+} glib_uniform_type;
+
+/*!
+    @brief A uniform value which is set before a queued draw
+*/
+typedef struct {
+    glib_uniform_handle_t uniform;
+    glib_uniform_type type;
+    union {
+        int i;
+        float f;
+        double d;
+        mat4 m;
+    } value;
+} glib_draw_uniform_t;
+
+/*!
+    @brief A draw of the render queue, see glib_make_draw and glib_submit_draw
+*/
+typedef struct {
+    glib_obj_t* obj;
+    unsigned int shader;
+    unsigned int textures[GLIB_DRAW_TEXTURES];  // bound to the slots from GLIB_TEX_SLOT0, 0 means the slot is not used
+    glib_draw_uniform_t uniforms[GLIB_DRAW_UNIFORMS];
+    unsigned int uniform_count;
+    unsigned int instance_count;    // 0 draws with glib_draw_obj, otherwise with glib_draw_obj_instanced
+    unsigned int lod;               // the LOD of the object which is drawn
+    unsigned char layer;            // lower layers are drawn first
+    bool transparent;               // drawn after the opaque draws of its layer, back to front, with alpha blending
+    float depth;                    // distance from the camera, opaque draws go front to back
+} glib_draw_t;
+
+/*!
+    @brief The directions of glib_camera_move
+*/
+typedef enum {
+    GLIB_CAMERA_FORWARD = 0,
+    GLIB_CAMERA_BACKWARD,
+    GLIB_CAMERA_LEFT,
+    GLIB_CAMERA_RIGHT,
+    GLIB_CAMERA_UP,
+    GLIB_CAMERA_DOWN,
+} glib_camera_movement;
+
+/*!
+    @brief A perspective camera, see glib_create_camera. Set dirty if you change a field directly
+*/
 typedef struct {
     vec3 position;
     vec3 front;
@@ -241,8 +604,67 @@ typedef struct {
     float movement_speed;
     float mouse_sensitivity;
     float zoom;
+
+    float near_plane;
+    float far_plane;
+    float aspect;       // the window aspect ratio of the projection
+
+    // cached, glib_update_camera rebuilds them when the camera is dirty or the window is resized
+    mat4 view;
+    mat4 proj;
+    mat4 view_proj;
+    vec4 planes[6];     // left, right, bottom, top, near, far frustum planes in world space, the normals point inward
+    bool dirty;
 } glib_camera_t;
 
+/*!
+    @brief Draws with model matrices which are culled against the camera frustum with a BVH, see glib_create_scene
+*/
+typedef struct glib_scene_t glib_scene_t;
+
+/*!
+    @brief Many meshes of one vertex layout in shared vertex and index buffers, drawn with one multi draw call, see glib_create_arena
+*/
+typedef struct glib_arena_t glib_arena_t;
+
+/*!
+    @brief The kinds of input events, see glib_drain_input_events
+*/
+typedef enum {
+    GLIB_INPUT_KEY = 0,
+    GLIB_INPUT_MOUSE_BUTTON,
+    GLIB_INPUT_CURSOR,
+} glib_input_type;
+
+/*!
+    @brief The actions of key and mouse button events
+*/
+typedef enum {
+    GLIB_INPUT_RELEASE = 0,
+    GLIB_INPUT_PRESS,
+    GLIB_INPUT_REPEAT,
+} glib_input_action;
+
+/*!
+    @brief An input event with the time it arrived
+*/
+typedef struct {
+    glib_input_type type;
+    int code;                   // the key code or the mouse button, it can be GLIB_KEY_UNKNOWN
+    glib_input_action action;
+    int mods;
+    double x, y;                // the cursor position in window pixels
+    double time;                // seconds, on the clock of glfwGetTime
+} glib_input_event_t;
+
+/*!
+    @brief Counters of the state changes (shader, texture, VAO and polygon mode binds, blend and depth state) which went through glib
+*/
+typedef struct {
+    unsigned long long issued;  // changes which reached OpenGL
+    unsigned long long skipped; // changes which were dropped, because the state was already set
+} glib_state_stats_t;
+
 /*!
     @brief Read content from a file into an allocated buffer
 
@@ -252,6 +674,45 @@ typedef struct {
 */
 char* glib_read_from_file(const char* file_name);
 
+/*!
+    @brief Map an asset pack made by glib_write_pack. The shader, texture and model loaders look up their paths in the mounted packs first and read the mapped data in place,
+    the paths which are not packed are loaded from the filesystem. A packed texture or model without a packed cache uses and writes the cache on the filesystem.
+    Mount the packs before loading from them and unmount them only when no async texture load is pending
+
+    @param file_path is the path to the pack file
+
+    @return If the pack is mapped than return true (1), otherwise false (0)
+*/
+bool glib_mount_pack(const char* file_path);
+
+/*!
+    @brief Unmap every mounted pack, the pointers from glib_find_packed are invalid after it
+*/
+void glib_unmount_packs(void);
+
+/*!
+    @brief Find a file in the mounted packs, the pack mounted last is searched first
+
+    @param path is the path of the file exactly as it was given to glib_write_pack
+    @param size is set to the size of the file if it is not NULL
+
+    @return The content in the mapped pack which is followed by a NUL byte, or NULL if the file is not packed
+*/
+const void* glib_find_packed(const char* path, size_t* size);
+
+/*!
+    @brief Pack files into one read only file: a header, the index sorted by path hash, the paths and the contents, each GLIB_PACK_ALIGNMENT aligned.
+    The caches next to the files (GLIB_MESH_CACHE_EXT, GLIB_TEXTURE_CACHE_EXT) are packed with them if they are made from the files as they are now,
+    the loaders use the packed caches without checking the source. Load the files once before packing them to write their caches
+
+    @param pack_path is the path of the pack file
+    @param file_paths are the files to pack, they are found by these paths later
+    @param count is the number of files
+
+    @return If the pack is written than return true (1), otherwise false (0)
+*/
+bool glib_write_pack(const char* pack_path, const char* const* file_paths, unsigned int count);
+
 /*!
     @brief Init OpenGL and other stuff
 */
@@ -266,6 +727,41 @@ void glib_init(void);
 */
 void glib_create_window(int width, int height, const char* title);
 
+/*!
+    @brief Create a hidden window whose context renders into an offscreen framebuffer of the given size. Use it instead of glib_create_window on machines without a display, e.g. with Mesa's software rasterizer
+    The main loop renders into the framebuffer and does not swap buffers. Stop it with glib_set_frame_limit or glib_stop, and read the frames with glib_set_readback_callback
+
+    @param width is the width of the framebuffer in pixels
+    @param height is the height of the framebuffer in pixels
+*/
+void glib_create_headless(int width, int height);
+
+/*!
+    @brief Check if the context was created with glib_create_headless
+
+    @return True (1) in headless mode
+*/
+bool glib_is_headless(void);
+
+/*!
+    @brief Stop the main loop after a number of frames
+
+    @param frames is the number of frames, 0 means no limit
+*/
+void glib_set_frame_limit(unsigned long long frames);
+
+/*!
+    @brief Stop the main loop after the current frame
+*/
+void glib_stop(void);
+
+/*!
+    @brief Accept a function which gets the color buffer of every frame. The frames are copied into pixel pack buffers and handed over when the GPU has finished them, so the readback does not stall the rendering
+
+    @param readback_fun gets the RGBA pixels from the bottom row up, the pointer is valid only during the call. NULL turns the readback off
+*/
+void glib_set_readback_callback(void (*readback_fun)(const unsigned char* pixels, int width, int height, unsigned long long frame));
+
 /*!
     @brief Set clear color
 
@@ -337,120 +833,496 @@ double glib_get_mouse_pos_y(void);
 int glib_get_mouse_drag_button(void);
 
 /*!
-    @brief Start the main loop and call the stored render function
+    @brief Check if a key went down since the last frame, a tap which is released in the same frame is seen too. In the update callback it is since the last update step, so a press is seen by one step
+
+    @param keycode the key what you want to check
+
+    @return true if the key was pressed
 */
-void glib_main_loop(void);
+bool glib_was_key_pressed(int keycode);
 
 /*!
-    @brief Create an object from your vertices and indices. This function also stores the VAO, VBO, EBO which is usefull for renderering this object
+    @brief Check if a key went up since the last frame, or since the last update step in the update callback
 
-    @param vertices the pointer to your vertices array
-    @param vertices_len the len of vertices array
-    @param indices the pointer to your indices array
-    @param indices_len the len of indices array
-
-    @return The object struct which stores some data
+    @param keycode the key what you want to check
 
+    @return true if the key was released
 */
-glib_obj_t* glib_create_obj(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len);
+bool glib_was_key_released(int keycode);
 
 /*!
-    @brief Create an object from your vertices and indices. This function also stores the VAO, VBO, EBO which is usefull for renderering this object
-
-    @param vertices the pointer to your vertices array
-    @param vertices_len the len of vertices array
+    @brief Check if a mouse button went down since the last frame, a click which is released in the same frame is seen too. In the update callback it is since the last update step, so a click is seen by one step
 
-    @return The object struct which stores some data
+    @param mouse_button the button what you want to check
 
+    @return true if the button was pressed
 */
-glib_obj_t* glib_create_obj_from_vert(float* vertices, unsigned int vertices_len);
+bool glib_was_mouse_pressed(int mouse_button);
 
 /*!
-    @brief Create a triangle object from coords
+    @brief Check if a mouse button went up since the last frame, or since the last update step in the update callback
 
-    @return The glib object reference which stores some data
+    @param mouse_button the button what you want to check
+
+    @return true if the button was released
 */
-glib_obj_t* glib_create_triangle_obj(float x1, float y1, float x2, float y2, float x3, float y3);
+bool glib_was_mouse_released(int mouse_button);
 
 /*!
-    @brief Create a triangle object from coords
+    @brief Take the input events in arrival order. The events of a frame can be drained until the next frame polls the events again, the rest of them are dropped then
 
-    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
+    @param events is the array which receives the events
+    @param max_events is the size of the array
 
-    @return The glib object reference which stores some data
+    @return The number of events written into the array
 */
-glib_obj_t* glib_create_triangle_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, int rgba_hex);
+unsigned int glib_drain_input_events(glib_input_event_t* events, unsigned int max_events);
 
 /*!
-    @brief Create a quad object from coords
+    @brief Get how many events were lost, because more than GLIB_INPUT_QUEUE_SIZE events came in one frame
 
-    @return The glib object reference which stores some data
+    @return The number of lost events
 */
-glib_obj_t* glib_create_quad_obj(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
+unsigned long long glib_get_dropped_input_events(void);
 
 /*!
-    @brief Create a quad object from coords
-    
-    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
-
-    @return The glib object reference which stores some data
+    @brief Start the main loop. Every frame it polls the events, runs the update function with fixed steps, calls the stored render function and waits for the target fps
 */
-glib_obj_t* glib_create_quad_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, int rgba_hex);
-
+void glib_main_loop(void);
 
 /*!
-    @brief Load models with OBJ file format
+    @brief Accept a function which runs with a fixed timestep (see glib_set_fixed_timestep), as many times per frame as the elapsed time needs. The render function can interpolate between the last two updates with glib_get_frame_alpha
 
-    @param file_path the path to your model
+    @param update_fun is the update function, dt is the fixed timestep in seconds
 */
-glib_obj_t* glib_load_obj(const char* file_path);
+void glib_set_update_callback(void (*update_fun)(double dt));
 
 /*!
-    @brief  Draw triangles using an glib obj
+    @brief Set the step of the update function. The default is GLIB_FIXED_TIMESTEP
 
-    @param obj is the glib obj
+    @param dt is the timestep in seconds
 */
-void glib_draw_obj(glib_obj_t* obj);
+void glib_set_fixed_timestep(double dt);
 
 /*!
-    @brief Draw just the frame around an object
+    @brief Limit the frame rate of the main loop. The loop sleeps while it can and spins for the last part of the frame, so the frame time stays precise
+
+    @param fps is the target frames per second, 0 turns the limit off
 */
-void glib_wired_draw(void);
+void glib_set_target_fps(double fps);
 
 /*!
-    @brief Draw the filled shape
+    @brief Set the vertical synchronization. Until this is called the driver default is used
+
+    @param interval is the number of screen updates to wait before swapping the buffers, 0 turns vsync off, -1 is adaptive vsync where it is supported
 */
-void glib_filled_draw(void);
+void glib_set_vsync(int interval);
 
 /*!
-    @brief Create a shader program from file
-
-    @param vert_file_path is the file path to your vertex shader file
-    @param frag_file_path is the file path to your fragment shader file
+    @brief Get the time between the start of the last two frames
 
-    @return The shader program ID
+    @return The delta time in seconds
 */
-unsigned int glib_create_shader(const char* vert_file_path, const char* frag_file_path);
+double glib_get_delta_time(void);
 
 /*!
-    @brief Create a shader program from memory
+    @brief Get the start of the current frame
 
-    @param vert_src is the vertex source code
-    @param frag_src is the fragment source code
+    @return The time in seconds since the main loop started
+*/
+double glib_get_time(void);
 
-    @return The shader program ID
+/*!
+    @brief Get how far the current frame is between the last update and the next one
+
+    @return The interpolation alpha 0-1, it is 0 without an update function
 */
-unsigned int glib_create_shader_from_memory(const char* vert_src, const char* frag_src);
+double glib_get_frame_alpha(void);
 
 /*!
-    @brief Apply shader for the further objects
+    @brief Get the number of rendered frames
 
-    @param shader_id is the ID of your shader program
+    @return The frame count
 */
-void glib_use_shader(int shader_id);
+unsigned long long glib_get_frame_count(void);
 
 /*!
-    @brief Upload int value into a shader
+    @brief A running profiling scope, see glib_profile_begin
+*/
+typedef struct {
+    const char* name;
+    unsigned long long start;
+    int gpu_query;
+} glib_profile_scope_t;
+
+/*!
+    @brief Turn the profiler on or off. While it is on, the scopes of glib and the user are recorded into a ring buffer of the last GLIB_PROFILER_CAPACITY events
+
+    @param enabled turns the profiler on or off
+*/
+void glib_profiler_enable(bool enabled);
+
+/*!
+    @brief Check the profiler
+
+    @return True (1) if the profiler records the scopes
+*/
+bool glib_profiler_is_enabled(void);
+
+/*!
+    @brief Start a profiling scope. It can be used from any thread, the scopes of a thread can be nested
+
+    @param name is the name of the scope, it has to live until the trace is written, e.g. a string literal
+    @param gpu also measures the GPU time of the GL commands of the scope with a pair of timestamp queries, so the GPU scopes can be nested too. It works on the thread of the window
+
+    @return The scope which has to be passed to glib_profile_end
+*/
+glib_profile_scope_t glib_profile_begin(const char* name, bool gpu);
+
+/*!
+    @brief End a profiling scope
+
+    @param scope is the scope returned by glib_profile_begin
+*/
+void glib_profile_end(glib_profile_scope_t scope);
+
+/*!
+    @brief Read the results of the finished GPU timer queries without waiting. The main loop calls it every frame, so it is only needed with your own loop
+*/
+void glib_profiler_collect(void);
+
+/*!
+    @brief Write the recorded events in the Chrome trace event JSON format, which can be opened in chrome://tracing or Perfetto
+
+    @param file_path the path to the JSON file
+
+    @return If the file is written than return true (1), otherwise false (0)
+*/
+bool glib_profiler_write_trace(const char* file_path);
+
+/*!
+    @brief Create an object from your vertices and indices. This function also stores the VAO, VBO, EBO which is usefull for renderering this object
+
+    @param vertices the pointer to your vertices array
+    @param vertices_len the len of vertices array
+    @param indices the pointer to your indices array
+    @param indices_len the len of indices array
+
+    @return The object struct which stores some data
+
+*/
+glib_obj_t* glib_create_obj(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len);
+
+/*!
+    @brief Create an object from your vertices and indices. This function also stores the VAO, VBO, EBO which is usefull for renderering this object
+
+    @param vertices the pointer to your vertices array
+    @param vertices_len the len of vertices array
+
+    @return The object struct which stores some data
+
+*/
+glib_obj_t* glib_create_obj_from_vert(float* vertices, unsigned int vertices_len);
+
+/*!
+    @brief Create an object like glib_create_obj, but with a buffer usage. Use GLIB_BUFFER_DYNAMIC or GLIB_BUFFER_STREAM for objects which are updated
+
+    @param vertices the pointer to your vertices array
+    @param vertices_len the len of vertices array
+    @param indices the pointer to your indices array, or NULL
+    @param indices_len the len of indices array
+    @param usage how often the object is updated
+
+    @return The object struct which stores some data
+*/
+glib_obj_t* glib_create_obj_with_usage(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len, glib_buffer_usage usage);
+
+/*!
+    @brief Replace the vertices of an object. Dynamic and stream objects are written into the next free copy of their vertex buffer, the buffer grows when the new vertices do not fit
+
+    @param obj is the glib obj
+    @param vertices the pointer to the new vertices array, the object refers to it from now on
+    @param vertices_len the len of vertices array
+*/
+void glib_update_obj_vertices(glib_obj_t* obj, float* vertices, unsigned int vertices_len);
+
+/*!
+    @brief Replace a range of the vertices of an object. The rest of the vertices are kept
+
+    @param obj is the glib obj
+    @param offset the index of the first replaced float
+    @param vertices the pointer to the new floats
+    @param len the number of the replaced floats, offset+len can not be greater than the vertices len of the object
+*/
+void glib_update_obj_vertices_range(glib_obj_t* obj, unsigned int offset, const float* vertices, unsigned int len);
+
+/*!
+    @brief Replace the indices of an object which has 32 bit indices. The index buffer is orphaned, so the update does not wait for the GPU
+
+    @param obj is the glib obj
+    @param indices the pointer to the new indices array, the object refers to it from now on
+    @param indices_len the len of indices array
+*/
+void glib_update_obj_indices(glib_obj_t* obj, unsigned int* indices, unsigned int indices_len);
+
+/*!
+    @brief Get the default vertex layout: 3 float position at location 0, 4 float color at location 1 and 2 float uv at location 2, 36 bytes
+
+    @return The layout descriptor
+*/
+glib_vertex_layout_t glib_default_vertex_layout(void);
+
+/*!
+    @brief Get a compact vertex layout for the default shader: 3 float position, 4 normalized unsigned byte color (RGBA order) and 2 half float uv, 20 bytes
+
+    @return The layout descriptor
+*/
+glib_vertex_layout_t glib_compact_vertex_layout(void);
+
+/*!
+    @brief Convert a float to the bits of a half float, for the GLIB_ATTRIB_HALF_FLOAT attributes
+
+    @param value the float value
+
+    @return The half float bits, rounded to nearest even
+*/
+unsigned short glib_float_to_half(float value);
+
+/*!
+    @brief Create an object with your own vertex layout and index type
+
+    @param vertices the pointer to the vertex data
+    @param vertex_count the number of vertices
+    @param layout the layout of one vertex, it is copied into the object
+    @param indices the pointer to the index data, or NULL
+    @param index_count the number of indices
+    @param index_type the type of the indices, GLIB_INDEX_UINT16 halves the index buffer
+    @param usage how often the object is updated
+
+    @return The object struct which stores some data
+*/
+glib_obj_t* glib_create_obj_with_layout(const void* vertices, unsigned int vertex_count, const glib_vertex_layout_t* layout, const void* indices, unsigned int index_count, glib_index_type index_type, glib_buffer_usage usage);
+
+/*!
+    @brief Replace the vertex data of an object of any vertex layout, like glib_update_obj_vertices
+
+    @param obj is the glib obj
+    @param vertices the pointer to the new vertex data, the object refers to it from now on
+    @param vertex_count the number of vertices
+*/
+void glib_update_obj_vertex_data(glib_obj_t* obj, const void* vertices, unsigned int vertex_count);
+
+/*!
+    @brief Replace a range of the vertices of an object of any vertex layout, like glib_update_obj_vertices_range
+
+    @param obj is the glib obj
+    @param first_vertex the index of the first replaced vertex
+    @param vertices the pointer to the new vertex data
+    @param vertex_count the number of the replaced vertices
+*/
+void glib_update_obj_vertex_data_range(glib_obj_t* obj, unsigned int first_vertex, const void* vertices, unsigned int vertex_count);
+
+/*!
+    @brief Replace the indices of an object with indices of the object's index type
+
+    @param obj is the glib obj
+    @param indices the pointer to the new index data, the object refers to it from now on
+    @param index_count the number of indices
+*/
+void glib_update_obj_index_data(glib_obj_t* obj, const void* indices, unsigned int index_count);
+
+/*!
+    @brief Create a triangle object from coords
+
+    @return The glib object reference which stores some data
+*/
+glib_obj_t* glib_create_triangle_obj(float x1, float y1, float x2, float y2, float x3, float y3);
+
+/*!
+    @brief Create a triangle object from coords
+
+    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
+
+    @return The glib object reference which stores some data
+*/
+glib_obj_t* glib_create_triangle_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, int rgba_hex);
+
+/*!
+    @brief Create a quad object from coords
+
+    @return The glib object reference which stores some data
+*/
+glib_obj_t* glib_create_quad_obj(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
+
+/*!
+    @brief Create a quad object from coords
+    
+    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
+
+    @return The glib object reference which stores some data
+*/
+glib_obj_t* glib_create_quad_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, int rgba_hex);
+
+
+/*!
+    @brief Load models with OBJ file format. Polygons are triangulated and every distinct position/uv/normal combination becomes one vertex of an indexed object.
+    The parsed model is cached in the binary mesh format next to the file (see GLIB_MESH_CACHE_EXT), and the cache is used while the OBJ file size and modification time match
+
+    @param file_path the path to your model
+
+    @return The glib object reference which stores some data
+*/
+glib_obj_t* glib_load_obj(const char* file_path);
+
+/*!
+    @brief Load a big OBJ model on GLIB_OBJ_THREADS threads. The file is memory mapped (or found in a mounted pack) and split at line boundaries, every thread parses the v and vt records of its part,
+    then the faces of the parts are triangulated and uploaded in batches of GLIB_OBJ_BATCH_VERTICES vertices, so the whole model is never in memory.
+    The vertices are deduplicated over the whole model like glib_load_obj does, the materials are ignored and no mesh cache is written
+
+    @param file_path the path to your model
+
+    @return The glib object reference, it has no CPU side vertices and indices
+*/
+glib_obj_t* glib_load_obj_parallel(const char* file_path);
+
+/*!
+    @brief Save the vertices and indices of an object into the glib binary mesh format
+
+    @param file_path the path to the binary mesh file
+    @param obj is the glib obj, its vertices and indices has to be still alive. Only the default vertex layout with 32 bit indices is supported
+
+    @return If the file is written than return true (1), otherwise false (0)
+*/
+bool glib_save_mesh(const char* file_path, glib_obj_t* obj);
+
+/*!
+    @brief Load a model from the glib binary mesh format. The file is memory mapped and its blocks are uploaded directly, so the returned object has no CPU side vertices and indices
+
+    @param file_path the path to the binary mesh file
+
+    @return The glib object reference which stores some data, or NULL if the file is not a valid mesh file
+*/
+glib_obj_t* glib_load_mesh(const char* file_path);
+
+/*!
+    @brief  Draw triangles using an glib obj
+
+    @param obj is the glib obj
+*/
+void glib_draw_obj(glib_obj_t* obj);
+
+/*!
+    @brief Upload the per instance data of an object. The first call attaches the instance attributes to the object's VAO (see GLIB_INSTANCE_MODEL_LOCATION and GLIB_INSTANCE_COLOR_LOCATION)
+
+    @param obj is the glib obj
+    @param instances is the array of the instance data
+    @param count is the number of instances
+*/
+void glib_set_obj_instances(glib_obj_t* obj, const glib_instance_t* instances, unsigned int count);
+
+/*!
+    @brief Draw many copies of an object with one draw call, using the instance data uploaded by glib_set_obj_instances. Use it with a shader which reads the instance attributes, like the default instanced shader
+
+    @param obj is the glib obj
+    @param instance_count is the number of instances to draw, it is clamped to the number of uploaded instances
+*/
+void glib_draw_obj_instanced(glib_obj_t* obj, unsigned int instance_count);
+
+/*!
+    @brief Build a LOD chain for an indexed object with quadric error edge collapses. Every LOD has about GLIB_LOD_RATIO times the triangles of the previous one,
+    its indices are stored after the indices of the object in the same index buffer and refer to the same vertices. The border and UV seam vertices are kept, so a LOD has no holes.
+    The vertices and indices are read back from the buffers unless the object owns its CPU side copy, the arrays given to glib_create_obj are not used. Updating the indices drops the chain
+
+    @param obj is the glib obj
+    @param lod_count is the number of levels with the full mesh, at most GLIB_MAX_LODS
+
+    @return The number of levels which are built, less than lod_count if the mesh can't be simplified further. With a lod_count of 0 nothing is built and the object is left as is
+*/
+unsigned int glib_build_obj_lods(glib_obj_t* obj, unsigned int lod_count);
+
+/*!
+    @brief Select a LOD of an object from the projected size of its bounding sphere: the coarsest LOD is taken whose simplification error covers at most GLIB_LOD_PIXEL_ERROR pixels.
+    The limit is moved by GLIB_LOD_HYSTERESIS away from the current LOD, so the LOD does not flicker when the size is near a limit
+
+    @param obj is the glib obj
+    @param model is the model matrix of the object
+    @param camera is the camera
+    @param current is the LOD which was drawn in the last frame
+
+    @return The LOD to draw
+*/
+unsigned int glib_select_obj_lod(const glib_obj_t* obj, mat4 model, const glib_camera_t* camera, unsigned int current);
+
+/*!
+    @brief Select the LOD which glib_draw_obj and glib_draw_obj_instanced draw, see glib_select_obj_lod. The scenes select the LOD of each of their draws themselves
+
+    @param obj is the glib obj
+    @param model is the model matrix of the object
+    @param camera is the camera
+*/
+void glib_update_obj_lod(glib_obj_t* obj, mat4 model, const glib_camera_t* camera);
+
+/*!
+    @brief Get the default instanced shader. It works like the default shader, but it reads the model matrix and the color of each instance from the instance attributes
+
+    @return The shader program ID
+*/
+unsigned int glib_get_default_instanced_shader(void);
+
+/*!
+    @brief Draw just the frame around an object
+*/
+void glib_wired_draw(void);
+
+/*!
+    @brief Draw the filled shape
+*/
+void glib_filled_draw(void);
+
+/*!
+    @brief Create a shader program from file.
+    The linked program is cached as a driver specific binary, keyed by the sources and the driver, and it is compiled again when the driver rejects the binary
+
+    @param vert_file_path is the file path to your vertex shader file
+    @param frag_file_path is the file path to your fragment shader file
+
+    @return The shader program ID
+*/
+unsigned int glib_create_shader(const char* vert_file_path, const char* frag_file_path);
+
+/*!
+    @brief Create a shader program from memory. It uses the same program binary cache as glib_create_shader
+
+    @param vert_src is the vertex source code
+    @param frag_src is the fragment source code
+
+    @return The shader program ID
+*/
+unsigned int glib_create_shader_from_memory(const char* vert_src, const char* frag_src);
+
+/*!
+    @brief Set the directory of the shader program binary cache. The default is GLIB_SHADER_CACHE_DIR
+
+    @param dir is the directory, it is created on the first write. NULL or "" turns off the cache
+*/
+void glib_set_shader_cache_dir(const char* dir);
+
+/*!
+    @brief Print the shader sources while they are compiled. It is off by default
+
+    @param enabled turns the printing on or off
+*/
+void glib_set_shader_echo(bool enabled);
+
+/*!
+    @brief Apply shader for the further objects
+
+    @param shader_id is the ID of your shader program
+*/
+void glib_use_shader(int shader_id);
+
+/*!
+    @brief Upload int value into a shader
 
     @param program_id is your shader program ID
     @param name is the uniform name in the shader
@@ -486,12 +1358,56 @@ void glib_set_uniform1d(int program_id, const char* name, double value);
 void glib_set_unifrom_mat4(int program_id, const char* name, mat4 value);
 
 /*!
-    @brief Load 2D texture from file. This 2D texture loader only work with the following color channel formats: RGBA, RGB 
+    @brief Get a handle to a uniform of a shader program. The uniforms are collected once when the program is linked, so this is a table lookup, not a GL call.
+    An array is found by its plain name or by "name[0]", another element ("name[3]") is located with GL the first time it is asked for
 
-    @param file_path is your file path into the texture
-    @param has_alpha which indicate if your texture has alpha channel
+    @param program_id is your shader program ID
+    @param name is the uniform name in the shader
 
-    @return The loaded texture ID
+    @return The uniform handle, its index is -1 if the program has no active uniform with this name
+*/
+glib_uniform_handle_t glib_get_uniform(int program_id, const char* name);
+
+/*!
+    @brief Upload int value into a shader through a uniform handle. The GL call is skipped if the uniform already has this value. The program has to be in use
+
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value which will be upload into yout uniform
+*/
+void glib_set_uniform1i_handle(glib_uniform_handle_t uniform, int value);
+
+/*!
+    @brief Upload float value into a shader through a uniform handle. The GL call is skipped if the uniform already has this value. The program has to be in use
+
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value which will be upload into yout uniform
+*/
+void glib_set_uniform1f_handle(glib_uniform_handle_t uniform, float value);
+
+/*!
+    @brief Upload double value into a shader through a uniform handle. The GL call is skipped if the uniform already has this value. The program has to be in use
+
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value which will be upload into yout uniform
+*/
+void glib_set_uniform1d_handle(glib_uniform_handle_t uniform, double value);
+
+/*!
+    @brief Upload matrix 4x4 value into a shader through a uniform handle. The GL call is skipped if the uniform already has this value. The program has to be in use
+
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value which will be upload into yout uniform
+*/
+void glib_set_uniform_mat4_handle(glib_uniform_handle_t uniform, mat4 value);
+
+/*!
+    @brief Load 2D texture from file. This 2D texture loader only work with the following color channel formats: RGBA, RGB.
+    The decoded image and its mip chain are cached next to the file (see GLIB_TEXTURE_CACHE_EXT), and the cache is used while the image file size and modification time match
+
+    @param file_path is your file path into the texture
+    @param has_alpha which indicate if your texture has alpha channel
+
+    @return The loaded texture ID
 */
 unsigned int glib_load_texture_2d(const char* file_path, unsigned char has_alpha);
 
@@ -514,642 +1430,7335 @@ unsigned int glib_load_texture_2d_from_memory(const char* raw_data, unsigned int
 */
 void glib_use_texture_2d(unsigned int texture, glib_texture_slot slot);
 
-#ifdef GLIB_IMPLEMENTATION
+/*!
+    @brief Load 2D texture from file in the background. The file is decoded on worker threads and uploaded by glib_main_loop in small time slices,
+    until then the handle resolves to the default texture. This 2D texture loader only work with the following color channel formats: RGBA, RGB
 
-const char glib_default_tex_jpg_raw[] = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x01, 0x00, 0x60, 
-0x00, 0x60, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01, 0x02, 
-0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x03, 0x05, 0x03, 0x03, 0x03, 0x03, 0x03, 0x06, 0x04, 
-0x04, 0x03, 0x05, 0x07, 0x06, 0x07, 0x07, 0x07, 0x06, 0x07, 0x07, 0x08, 0x09, 0x0B, 0x09, 0x08, 
-0x08, 0x0A, 0x08, 0x07, 0x07, 0x0A, 0x0D, 0x0A, 0x0A, 0x0B, 0x0C, 0x0C, 0x0C, 0x0C, 0x07, 0x09, 
-0x0E, 0x0F, 0x0D, 0x0C, 0x0E, 0x0B, 0x0C, 0x0C, 0x0C, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x02, 0x02, 
-0x02, 0x03, 0x03, 0x03, 0x06, 0x03, 0x03, 0x06, 0x0C, 0x08, 0x07, 0x08, 0x0C, 0x0C, 0x0C, 0x0C, 
-0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 
-0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 
-0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0xFF, 0xC0, 
-0x00, 0x11, 0x08, 0x00, 0x01, 0x00, 0x01, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 
-0x01, 0xFF, 0xC4, 0x00, 0x1F, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 
-0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 
-0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 
-0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 
-0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 
-0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 
-0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 
-0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 
-0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 
-0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 
-0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 
-0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 
-0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xC4, 0x00, 0x1F, 0x01, 0x00, 0x03, 
-0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 
-0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x11, 0x00, 
-0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 
-0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 
-0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15, 
-0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27, 
-0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 
-0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 
-0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 
-0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 
-0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 
-0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2, 
-0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 
-0xFA, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0xFD, 
-0xFC, 0xA2, 0x8A, 0x28, 0x03, 0xFF, 0xD9};
+    @param file_path is your file path into the texture
+    @param has_alpha which indicate if your texture has alpha channel
 
-const char* glib_default_vert = {
-    "#version 330 core\n"
-    "layout (location = 0) in vec3 pos;\n"
-    "layout (location = 1) in vec4 col;\n"
-    "layout (location = 2) in vec2 tex_coord;\n"
-    "uniform mat4 model;\n"
-    "uniform mat4 view;\n"
-    "uniform mat4 proj;\n"
-    "out vec4 b_col;\n"
-    "out vec2 b_tex_coord;\n"
-    "void main(){\n"
-        "b_col = col;\n"
-        "b_tex_coord = tex_coord;\n"
-        "gl_Position = proj*view*model*vec4(pos, 1.0);\n"
-    "}\n"
-};
+    @return The handle of the texture
+*/
+glib_async_texture_t glib_load_texture_2d_async(const char* file_path, unsigned char has_alpha);
+
+/*!
+    @brief Get the texture ID of an async texture
+
+    @param texture is the handle from glib_load_texture_2d_async
+
+    @return The texture ID if the texture is uploaded, otherwise the default texture ID
+*/
+unsigned int glib_get_async_texture(glib_async_texture_t texture);
+
+/*!
+    @brief Get the loading state of an async texture
+
+    @param texture is the handle from glib_load_texture_2d_async
+
+    @return The state of the texture, see glib_texture_state
+*/
+glib_texture_state glib_get_async_texture_state(glib_async_texture_t texture);
+
+/*!
+    @brief Wait until an async texture is decoded and upload it right away
+
+    @param texture is the handle from glib_load_texture_2d_async
+
+    @return The texture ID, or the default texture ID if the loading failed
+*/
+unsigned int glib_wait_async_texture(glib_async_texture_t texture);
+
+/*!
+    @brief Upload decoded async textures until the time budget is used up. glib_main_loop calls it every frame, at least one texture is uploaded per call
+
+    @param budget is the time limit in seconds
+*/
+void glib_process_texture_uploads(double budget);
+
+/*!
+    @brief Set the time which glib_main_loop spends with async texture uploads in a frame
+
+    @param budget is the time limit in seconds, see GLIB_TEXTURE_UPLOAD_BUDGET for the default
+*/
+void glib_set_texture_upload_budget(double budget);
+
+/*!
+    @brief Create a texture atlas builder. Images added to it are packed into one or more RGBA textures (pages) by glib_atlas_build
+
+    @param page_width is the width of an atlas texture in pixels
+    @param page_height is the height of an atlas texture in pixels
+    @param padding is the border in pixels around each image which is filled with its edge pixels, so filtering and mipmaps don't bleed the neighbours in
+
+    @return The atlas builder
+*/
+glib_atlas_t* glib_create_atlas(int page_width, int page_height, int padding);
+
+/*!
+    @brief Add an image file to the atlas
+
+    @param atlas is the atlas builder
+    @param file_path is your file path into the image
+
+    @return The region ID of the image, see glib_atlas_get_region
+*/
+int glib_atlas_add_image(glib_atlas_t* atlas, const char* file_path);
+
+/*!
+    @brief Add an image from memory to the atlas
+
+    @param atlas is the atlas builder
+    @param pixels is the RGBA pixel data, bottom row first. The data is copied
+    @param width is the width of the image in pixels
+    @param height is the height of the image in pixels
+
+    @return The region ID of the image, see glib_atlas_get_region
+*/
+int glib_atlas_add_image_from_memory(glib_atlas_t* atlas, const unsigned char* pixels, int width, int height);
+
+/*!
+    @brief Pack the added images with the skyline algorithm and upload the atlas textures. The atlas can be built only once
+
+    @param atlas is the atlas builder
+
+    @return The number of atlas textures
+*/
+int glib_atlas_build(glib_atlas_t* atlas);
+
+/*!
+    @brief Get the texture and uv rectangle of an image in a built atlas
+
+    @param atlas is the atlas builder
+    @param region is the region ID from glib_atlas_add_image
+
+    @return The region
+*/
+glib_atlas_region_t glib_atlas_get_region(glib_atlas_t* atlas, int region);
+
+/*!
+    @brief Map the texture coords of an object into an atlas region. The current uvs of the object are stretched from their bounding box to the region, so a quad from glib_create_quad_obj shows exactly the packed image.
+    Only the GPU copy of the vertices is changed
+
+    @param obj is the glib obj
+    @param region is the atlas region
+*/
+void glib_set_obj_uv_region(glib_obj_t* obj, glib_atlas_region_t region);
+
+/*!
+    @brief Start collecting quads into the batch renderer. The batch starts with the default shader and the default texture
+*/
+void glib_batch_begin(void);
+
+/*!
+    @brief Set the shader for the next quads in the batch. If the shader differs from the current one the pending quads are flushed
+
+    @param shader_id is the ID of your shader program
+*/
+void glib_batch_set_shader(unsigned int shader_id);
+
+/*!
+    @brief Set the texture (slot 0) for the next quads in the batch. If the texture differs from the current one the pending quads are flushed
+
+    @param texture is the texture ID
+*/
+void glib_batch_set_texture(unsigned int texture);
+
+/*!
+    @brief Push a quad into the batch from raw vertex data
+
+    @param vertices points to 4 vertices (4*GLIB_VERTEX_FLOAT_COUNT floats) in the pos/color/uv layout, in the same order as glib_create_quad_obj
+*/
+void glib_batch_push_vertices(const float* vertices);
+
+/*!
+    @brief Push a quad into the batch from coords, like glib_create_quad_obj_ex
+
+    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
+*/
+void glib_batch_push_quad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, int rgba_hex);
+
+/*!
+    @brief Push an axis aligned rectangle into the batch with its own texture coords
+
+    @param x is the left side of the rectangle
+    @param y is the bottom side of the rectangle
+    @param w is the width of the rectangle
+    @param h is the height of the rectangle
+    @param u0 v0 is the bottom left texture coord
+    @param u1 v1 is the top right texture coord
+    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
+*/
+void glib_batch_push_rect(float x, float y, float w, float h, float u0, float v0, float u1, float v1, int rgba_hex);
+
+/*!
+    @brief Flush the remaining quads and finish the batch
+*/
+void glib_batch_end(void);
+
+/*!
+    @brief Get how many draw calls the batch renderer issued since the last glib_batch_begin
+
+    @return The number of draw calls
+*/
+unsigned int glib_batch_get_draw_calls(void);
+
+/*!
+    @brief Load a TrueType font for glib_draw_text. The glyphs are rendered on demand as signed distance fields into single channel atlas textures of GLIB_FONT_ATLAS_SIZE pixels, so the text stays sharp at any size.
+    The file is memory mapped, or read in place from a mounted pack, which has to stay mounted while the font is used
+
+    @param file_path is your file path into the font
+
+    @return The font
+*/
+glib_font_t* glib_load_font(const char* file_path);
+
+/*!
+    @brief Destroy a font with its atlas textures and layout cache. The texts of the font which are not flushed yet are dropped
+
+    @param font is the font
+*/
+void glib_destroy_font(glib_font_t* font);
+
+/*!
+    @brief Draw a text in window pixels, the origin is the bottom left corner of the window. The layout of a string (glyphs, kerning and lines) is cached, so an unchanged label only writes its quads again.
+    The quads are collected for the frame and glib_flush_text draws them over the scene through the batch stream buffer, with one draw call per atlas texture
+
+    @param font is the font
+    @param text is the UTF-8 text, '\n' starts a new line
+    @param x is the left side of the text in pixels
+    @param y is the baseline of the first line in pixels
+    @param size is the height of the font in pixels, from the lowest descender to the highest ascender
+    @param rgba_hex A color format example r:255 g:0 b:0 a:255 => 0xFF0000FF
+*/
+void glib_draw_text(glib_font_t* font, const char* text, float x, float y, float size, int rgba_hex);
+
+/*!
+    @brief Get the size of a text as glib_draw_text would draw it
+
+    @param font is the font
+    @param text is the UTF-8 text
+    @param size is the height of the font in pixels
+    @param width is set to the width of the longest line in pixels
+    @param height is set to the height of the lines in pixels
+*/
+void glib_measure_text(glib_font_t* font, const char* text, float size, float* width, float* height);
+
+/*!
+    @brief Draw the texts of glib_draw_text. The main loop calls it after the render queue
+*/
+void glib_flush_text(void);
+
+/*!
+    @brief Get how many draw calls the last glib_flush_text issued
+
+    @return The number of draw calls
+*/
+unsigned int glib_text_get_draw_calls(void);
+
+/*!
+    @brief Get how many state changes was issued and skipped by the state cache since the last reset
+
+    @return The counters
+*/
+glib_state_stats_t glib_get_state_stats(void);
+
+/*!
+    @brief Reset the state change counters to zero
+*/
+void glib_reset_state_stats(void);
+
+/*!
+    @brief Forget the cached GL state. Call this if you bind programs, textures or VAOs or change the blend or depth state with raw OpenGL calls, so glib doesn't skip a bind which is needed
+*/
+void glib_invalidate_state_cache(void);
+
+/*!
+    @brief Get the handle of an object. A handle can be kept in place of the pointer, it is detected when the object is destroyed
+
+    @param obj is the glib obj
+
+    @return The handle
+*/
+glib_handle_t glib_obj_handle(glib_obj_t* obj);
+
+/*!
+    @brief Get the object of a handle
+
+    @param handle is the handle from glib_obj_handle
+
+    @return The object, or NULL if it was destroyed
+*/
+glib_obj_t* glib_get_obj(glib_handle_t handle);
+
+/*!
+    @brief Destroy an object. Its GL buffers are deleted when the GPU finished the frames which use them, see glib_collect_garbage
+
+    @param obj is the glib obj, it can not be used after this call
+*/
+void glib_destroy_obj(glib_obj_t* obj);
+
+/*!
+    @brief Get the handle of a shader program which was made by glib
+
+    @param shader_id is the shader program ID
+
+    @return The handle, or GLIB_INVALID_HANDLE if the program is unknown
+*/
+glib_handle_t glib_shader_handle(unsigned int shader_id);
+
+/*!
+    @brief Get the shader program of a handle
+
+    @param handle is the handle from glib_shader_handle
+
+    @return The shader program ID, or 0 if it was destroyed
+*/
+unsigned int glib_get_shader(glib_handle_t handle);
+
+/*!
+    @brief Destroy a shader program, the program is deleted when the GPU finished the frames which use it
+
+    @param shader_id is the shader program ID
+*/
+void glib_destroy_shader(unsigned int shader_id);
+
+/*!
+    @brief Get the handle of a texture which was loaded by glib
+
+    @param texture is the texture ID
+
+    @return The handle, or GLIB_INVALID_HANDLE if the texture is unknown
+*/
+glib_handle_t glib_texture_handle(unsigned int texture);
+
+/*!
+    @brief Get the texture of a handle
+
+    @param handle is the handle from glib_texture_handle
+
+    @return The texture ID, or 0 if it was destroyed
+*/
+unsigned int glib_get_texture(glib_handle_t handle);
+
+/*!
+    @brief Destroy a texture, the texture is deleted when the GPU finished the frames which use it
+
+    @param texture is the texture ID
+*/
+void glib_destroy_texture(unsigned int texture);
+
+/*!
+    @brief Destroy every object, shader program and texture, except the default ones and the atlas pages of the fonts. Useful when a scene is unloaded
+*/
+void glib_destroy_all(void);
+
+/*!
+    @brief Delete the GL resources of the destroyed objects, shaders and textures which the GPU does not use any more. The main loop calls it every frame
+
+    @param wait is true to wait for the GPU and delete everything
+*/
+void glib_collect_garbage(bool wait);
+
+/*!
+    @brief Create a geometry arena: one vertex buffer, one index buffer and one VAO for many meshes of the same vertex layout. The buffers grow when they are full
+
+    @param layout is the vertex layout of every mesh, locations GLIB_INSTANCE_MODEL_LOCATION.. are taken by the instance attributes
+    @param vertex_capacity is the initial number of vertices
+    @param index_capacity is the initial number of 32 bit indices
+
+    @return The arena
+*/
+glib_arena_t* glib_create_arena(const glib_vertex_layout_t* layout, unsigned int vertex_capacity, unsigned int index_capacity);
+
+/*!
+    @brief Copy a mesh into an arena. The indices are relative to the first vertex of the mesh
+
+    @param arena is the arena
+    @param vertices is the vertex data in the layout of the arena
+    @param vertex_count is the number of vertices
+    @param indices is the index data
+    @param index_count is the number of indices
+
+    @return The handle of the mesh
+*/
+glib_handle_t glib_arena_add_mesh(glib_arena_t* arena, const void* vertices, unsigned int vertex_count, const unsigned int* indices, unsigned int index_count);
+
+/*!
+    @brief Remove a mesh from an arena, its ranges are reused by the next meshes
+
+    @param arena is the arena
+    @param mesh is the handle from glib_arena_add_mesh
+*/
+void glib_arena_remove_mesh(glib_arena_t* arena, glib_handle_t mesh);
+
+/*!
+    @brief Move the meshes of an arena next to each other, so the free space is one block at the end. glib_arena_add_mesh does it when no free block is big enough
+
+    @param arena is the arena
+*/
+void glib_arena_defragment(glib_arena_t* arena);
+
+/*!
+    @brief Draw meshes of an arena with one multi draw call. The draw i gets the instance i, so the default instanced shader moves each mesh with its own model matrix.
+    Without GL_ARB_multi_draw_indirect the meshes are drawn with glMultiDrawElementsBaseVertex, or one by one if they have instance data
+
+    @param arena is the arena
+    @param meshes is the array of mesh handles, the removed ones are skipped
+    @param instances is the per draw instance data, or NULL to draw every mesh with an identity model and white color
+    @param count is the number of meshes
+*/
+void glib_arena_draw(glib_arena_t* arena, const glib_handle_t* meshes, const glib_instance_t* instances, unsigned int count);
+
+/*!
+    @brief Free an arena with its meshes and GL buffers
+
+    @param arena is the arena
+*/
+void glib_destroy_arena(glib_arena_t* arena);
+
+/*!
+    @brief Make a queued draw of an object with one texture in slot 0. The other fields can be set before the submit
+
+    @param obj is the glib obj
+    @param shader is the shader program ID
+    @param texture is the texture ID, 0 means no texture
+
+    @return The draw
+*/
+glib_draw_t glib_make_draw(glib_obj_t* obj, unsigned int shader, unsigned int texture);
+
+/*!
+    @brief Add an int uniform value to a queued draw. The handle has to belong to the shader of the draw
+
+    @param draw is the draw
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value
+*/
+void glib_draw_set_uniform1i(glib_draw_t* draw, glib_uniform_handle_t uniform, int value);
+
+/*!
+    @brief Add a float uniform value to a queued draw. The handle has to belong to the shader of the draw
+
+    @param draw is the draw
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value
+*/
+void glib_draw_set_uniform1f(glib_draw_t* draw, glib_uniform_handle_t uniform, float value);
+
+/*!
+    @brief Add a double uniform value to a queued draw. The handle has to belong to the shader of the draw
+
+    @param draw is the draw
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value
+*/
+void glib_draw_set_uniform1d(glib_draw_t* draw, glib_uniform_handle_t uniform, double value);
+
+/*!
+    @brief Add a matrix 4x4 uniform value to a queued draw. The handle has to belong to the shader of the draw
+
+    @param draw is the draw
+    @param uniform is the handle from glib_get_uniform
+    @param value is the value
+*/
+void glib_draw_set_uniform_mat4(glib_draw_t* draw, glib_uniform_handle_t uniform, mat4 value);
+
+/*!
+    @brief Put a draw into the render queue. The draw is copied, and it is executed by glib_flush_render_queue, which the main loop calls after the render callback
+
+    @param draw is the draw
+*/
+void glib_submit_draw(const glib_draw_t* draw);
+
+/*!
+    @brief Sort the queued draws by layer, opaque/transparent, shader, texture and depth, then draw them and empty the queue.
+    Each program and texture is bound once per run of draws which use it
+*/
+void glib_flush_render_queue(void);
+
+/*!
+    @brief Create a perspective camera which looks along the -Z axis, with the default YAW, PITCH, SPEED, SENSITIVITY and ZOOM
+
+    @param position is the camera position in world space
+
+    @return The camera
+*/
+glib_camera_t glib_create_camera(vec3 position);
+
+/*!
+    @brief Move the camera with its movement speed
+
+    @param camera is the camera
+    @param direction is the direction relative to the camera
+    @param dt is the elapsed time in seconds
+*/
+void glib_camera_move(glib_camera_t* camera, glib_camera_movement direction, float dt);
+
+/*!
+    @brief Turn the camera with its mouse sensitivity, the pitch is clamped to [-89, 89] degrees
+
+    @param camera is the camera
+    @param x_offset is the yaw change, e.g. the mouse x movement
+    @param y_offset is the pitch change, e.g. the mouse y movement
+*/
+void glib_camera_rotate(glib_camera_t* camera, float x_offset, float y_offset);
+
+/*!
+    @brief Change the field of view of the camera, it is clamped to [1, ZOOM] degrees
+
+    @param camera is the camera
+    @param offset is subtracted from the field of view, e.g. the scroll offset
+*/
+void glib_camera_zoom(glib_camera_t* camera, float offset);
+
+/*!
+    @brief Set the near and far clip plane distances of the camera
+
+    @param camera is the camera
+    @param near_plane is the distance of the near plane
+    @param far_plane is the distance of the far plane
+*/
+void glib_camera_set_clip(glib_camera_t* camera, float near_plane, float far_plane);
+
+/*!
+    @brief Rebuild the view, projection and frustum planes of the camera if it is dirty or the window aspect ratio changed
+
+    @param camera is the camera
+*/
+void glib_update_camera(glib_camera_t* camera);
+
+/*!
+    @brief Use a camera for the default shaders. The main loop uploads its view and proj matrices before every render callback
+
+    @param camera is the camera, NULL sets identity matrices, so the default shaders draw in normalized device coords again
+*/
+void glib_use_camera(glib_camera_t* camera);
+
+/*!
+    @brief Test the bounding box of an object against the frustum of a camera
+
+    @param camera is the camera
+    @param obj is the glib obj
+    @param model is the model matrix of the object
+
+    @return false if the object is surely out of the view
+*/
+bool glib_camera_sees_obj(glib_camera_t* camera, glib_obj_t* obj, mat4 model);
+
+/*!
+    @brief Create an empty scene
+
+    @return The scene
+*/
+glib_scene_t* glib_create_scene(void);
+
+/*!
+    @brief Add a draw to a scene. The model matrix is set through the "model" uniform of the draw's shader, so the draw can have GLIB_DRAW_UNIFORMS-1 uniforms at most
+
+    @param scene is the scene
+    @param draw is the draw, it is copied
+    @param model is the model matrix
+
+    @return The index of the draw in the scene
+*/
+int glib_scene_add(glib_scene_t* scene, const glib_draw_t* draw, mat4 model);
+
+/*!
+    @brief Change the model matrix of a draw of a scene
+
+    @param scene is the scene
+    @param index is the index from glib_scene_add
+    @param model is the new model matrix
+*/
+void glib_scene_set_model(glib_scene_t* scene, int index, mat4 model);
+
+/*!
+    @brief Submit the draws of a scene which are in the view of the camera into the render queue, with their distance from the camera as depth.
+    The BVH of the scene is rebuilt after adds and refitted after model changes
+
+    @param scene is the scene
+    @param camera is the camera
+
+    @return The number of submitted draws
+*/
+unsigned int glib_scene_submit(glib_scene_t* scene, glib_camera_t* camera);
+
+/*!
+    @brief Free a scene, the objects of its draws are not freed
+
+    @param scene is the scene
+*/
+void glib_destroy_scene(glib_scene_t* scene);
+
+#ifdef GLIB_IMPLEMENTATION
+
+const char glib_default_tex_jpg_raw[] = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x01, 0x00, 0x60, 
+0x00, 0x60, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01, 0x02, 
+0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x03, 0x05, 0x03, 0x03, 0x03, 0x03, 0x03, 0x06, 0x04, 
+0x04, 0x03, 0x05, 0x07, 0x06, 0x07, 0x07, 0x07, 0x06, 0x07, 0x07, 0x08, 0x09, 0x0B, 0x09, 0x08, 
+0x08, 0x0A, 0x08, 0x07, 0x07, 0x0A, 0x0D, 0x0A, 0x0A, 0x0B, 0x0C, 0x0C, 0x0C, 0x0C, 0x07, 0x09, 
+0x0E, 0x0F, 0x0D, 0x0C, 0x0E, 0x0B, 0x0C, 0x0C, 0x0C, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x02, 0x02, 
+0x02, 0x03, 0x03, 0x03, 0x06, 0x03, 0x03, 0x06, 0x0C, 0x08, 0x07, 0x08, 0x0C, 0x0C, 0x0C, 0x0C, 
+0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 
+0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 
+0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0xFF, 0xC0, 
+0x00, 0x11, 0x08, 0x00, 0x01, 0x00, 0x01, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 
+0x01, 0xFF, 0xC4, 0x00, 0x1F, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 
+0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 
+0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 
+0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 
+0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 
+0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 
+0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 
+0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 
+0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 
+0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 
+0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 
+0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 
+0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xC4, 0x00, 0x1F, 0x01, 0x00, 0x03, 
+0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 
+0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x11, 0x00, 
+0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 
+0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 
+0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15, 
+0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27, 
+0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 
+0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 
+0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 
+0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 
+0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 
+0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2, 
+0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 
+0xFA, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0xFD, 
+0xFC, 0xA2, 0x8A, 0x28, 0x03, 0xFF, 0xD9};
+
+const char* glib_default_vert = {
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 pos;\n"
+    "layout (location = 1) in vec4 col;\n"
+    "layout (location = 2) in vec2 tex_coord;\n"
+    "uniform mat4 model;\n"
+    "uniform mat4 view;\n"
+    "uniform mat4 proj;\n"
+    "out vec4 b_col;\n"
+    "out vec2 b_tex_coord;\n"
+    "void main(){\n"
+        "b_col = col;\n"
+        "b_tex_coord = tex_coord;\n"
+        "gl_Position = proj*view*model*vec4(pos, 1.0);\n"
+    "}\n"
+};
+
+const char* glib_default_instanced_vert = {
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 pos;\n"
+    "layout (location = 1) in vec4 col;\n"
+    "layout (location = 2) in vec2 tex_coord;\n"
+    "layout (location = 3) in mat4 instance_model;\n"
+    "layout (location = 7) in vec4 instance_col;\n"
+    "uniform mat4 model;\n"
+    "uniform mat4 view;\n"
+    "uniform mat4 proj;\n"
+    "out vec4 b_col;\n"
+    "out vec2 b_tex_coord;\n"
+    "void main(){\n"
+        "b_col = col*instance_col;\n"
+        "b_tex_coord = tex_coord;\n"
+        "gl_Position = proj*view*model*instance_model*vec4(pos, 1.0);\n"
+    "}\n"
+};
+
+const char* glib_default_frag = {
+    "#version 330 core\n"
+    "in vec4 b_col;\n"
+    "in vec2 b_tex_coord;\n"
+    "uniform sampler2D tex0;\n"
+    "out vec4 FragColor;\n"
+    "void main(){\n"
+        "FragColor = texture(tex0, b_tex_coord)*b_col;\n"
+    "}\n"
+};
+
+// the distance field is 0.5 on the outline, the edge is smoothed over about a pixel at any text size
+const char* glib_text_frag = {
+    "#version 330 core\n"
+    "in vec4 b_col;\n"
+    "in vec2 b_tex_coord;\n"
+    "uniform sampler2D tex0;\n"
+    "out vec4 FragColor;\n"
+    "void main(){\n"
+        "float distance = texture(tex0, b_tex_coord).r;\n"
+        "float width = fwidth(distance)*0.7;\n"
+        "FragColor = vec4(b_col.rgb, b_col.a*smoothstep(0.5-width, 0.5+width, distance));\n"
+    "}\n"
+};
+
+GLFWwindow* glib_window;
+
+unsigned int glib_window_width;
+unsigned int glib_window_height;
+
+void (*glib_render_fun)(void) = NULL;
+void (*glib_framebuffer_resize_fun)(int width, int height) = NULL;
+
+unsigned int glib_default_tex;
+
+unsigned int glib_default_shader;
+unsigned int glib_default_instanced_shader;
+unsigned int glib_text_shader;
+
+bool glib_keyboard_pressed[GLIB_MAX_KEYBOARD_KEY_SUPPORTED];
+bool glib_mouse_pressed[GLIB_MAX_MOUSE_BUTTON_SUPPORTED];
+bool glib_mouse_dragging;
+int glib_mouse_drag_button;
+double glib_mouse_pos_x;
+double glib_mouse_pos_y;
+// the presses and releases since the last frame, and since the last update step, which runs 0..n times in a frame
+#define GLIB_EDGES_FRAME 0
+#define GLIB_EDGES_STEP 1
+bool glib_keyboard_press_edge[2][GLIB_MAX_KEYBOARD_KEY_SUPPORTED];
+bool glib_keyboard_release_edge[2][GLIB_MAX_KEYBOARD_KEY_SUPPORTED];
+bool glib_mouse_press_edge[2][GLIB_MAX_MOUSE_BUTTON_SUPPORTED];
+bool glib_mouse_release_edge[2][GLIB_MAX_MOUSE_BUTTON_SUPPORTED];
+int glib_input_edges = GLIB_EDGES_FRAME;    // the set which the edge queries read, the step set inside the update callback
+
+double glib_texture_upload_budget = GLIB_TEXTURE_UPLOAD_BUDGET;
+
+void (*glib_update_fun)(double dt) = NULL;
+
+typedef struct {
+    double target_fps;      // 0 means no limit
+    double fixed_timestep;
+    int swap_interval;
+    bool has_swap_interval; // the driver default is kept until glib_set_vsync
+    double delta;
+    double time;
+    double alpha;
+    unsigned long long frame_count;
+    // statistics of the oversleep of a short sleep, see glib_wait_until
+    double sleep_mean;
+    double sleep_var;
+    double sleep_dev;
+    unsigned long long sleep_count;
+} glib_frame_t;
+
+glib_frame_t glib_frame = {.fixed_timestep = GLIB_FIXED_TIMESTEP, .sleep_mean = 0.002};
+static void glib_stop_texture_workers(void);
+static void glib_upload_camera(void);
+static glib_obj_t* glib_alloc_obj(void);
+static void glib_register_shader(unsigned int shader_id);
+static void glib_register_texture(unsigned int texture);
+static void glib_defer_delete(GLenum type, unsigned int name);
+static void glib_release_texture(unsigned int texture);
+static bool glib_cache_is_current(const char* file_path, const char* cache_path);
+
+const float YAW         = -90.0f;
+const float PITCH       =  0.0f;
+const float SPEED       =  2.5f;
+const float SENSITIVITY =  0.1f;
+const float ZOOM        =  45.0f;
+
+// Shadow copy of the GL state which glib binds, every bind goes through it to drop the redundant ones
+#define GLIB_STATE_UNKNOWN 0xFFFFFFFFu
+
+typedef struct {
+    unsigned int program;
+    unsigned int active_unit;
+    unsigned int textures[GLIB_TEX_SLOT_COUNT];
+    unsigned int VAO;
+    unsigned int polygon_mode;
+    // 1 or 0 when known
+    unsigned int blend;
+    unsigned int depth_test;
+    unsigned int depth_mask;
+    unsigned int blend_src;
+    unsigned int blend_dst;
+} glib_gl_state_t;
+
+// the blend and depth state which the glib passes set, they put back the state of the caller when they are done
+typedef struct {
+    bool blend;
+    bool depth_test;
+    bool depth_mask;
+    unsigned int blend_src;
+    unsigned int blend_dst;
+} glib_blend_state_t;
+
+glib_gl_state_t glib_gl_state;
+glib_state_stats_t glib_state_stats;
+
+static void glib_bind_program(unsigned int program_id){
+    if(glib_gl_state.program==program_id){
+        glib_state_stats.skipped++;
+        return;
+    }
+    glUseProgram(program_id);
+    glib_gl_state.program = program_id;
+    glib_state_stats.issued++;
+}
+
+static void glib_bind_texture_unit(unsigned int unit){
+    if(glib_gl_state.active_unit==unit){
+        glib_state_stats.skipped++;
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0+unit);
+    glib_gl_state.active_unit = unit;
+    glib_state_stats.issued++;
+}
+
+static void glib_bind_texture(unsigned int unit, unsigned int texture){
+    if(glib_gl_state.textures[unit]==texture){
+        glib_state_stats.skipped++;
+        return;
+    }
+    // the unit switch is a part of the bind, it is counted only when it is issued
+    if(glib_gl_state.active_unit!=unit){
+        glActiveTexture(GL_TEXTURE0+unit);
+        glib_gl_state.active_unit = unit;
+        glib_state_stats.issued++;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glib_gl_state.textures[unit] = texture;
+    glib_state_stats.issued++;
+}
+
+static void glib_bind_vao(unsigned int VAO){
+    if(glib_gl_state.VAO==VAO){
+        glib_state_stats.skipped++;
+        return;
+    }
+    glBindVertexArray(VAO);
+    glib_gl_state.VAO = VAO;
+    glib_state_stats.issued++;
+}
+
+static void glib_set_polygon_mode(unsigned int mode){
+    if(glib_gl_state.polygon_mode==mode){
+        glib_state_stats.skipped++;
+        return;
+    }
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    glib_gl_state.polygon_mode = mode;
+    glib_state_stats.issued++;
+}
+
+static void glib_set_capability(unsigned int* state, GLenum cap, bool enabled){
+    if(*state==(unsigned int)enabled){
+        glib_state_stats.skipped++;
+        return;
+    }
+    if(enabled){
+        glEnable(cap);
+    }else{
+        glDisable(cap);
+    }
+    *state = enabled;
+    glib_state_stats.issued++;
+}
+
+static void glib_set_depth_mask(bool enabled){
+    if(glib_gl_state.depth_mask==(unsigned int)enabled){
+        glib_state_stats.skipped++;
+        return;
+    }
+    glDepthMask(enabled?GL_TRUE:GL_FALSE);
+    glib_gl_state.depth_mask = enabled;
+    glib_state_stats.issued++;
+}
+
+static void glib_set_blend_func(unsigned int src, unsigned int dst){
+    if(glib_gl_state.blend_src==src && glib_gl_state.blend_dst==dst){
+        glib_state_stats.skipped++;
+        return;
+    }
+    glBlendFunc(src, dst);
+    glib_gl_state.blend_src = src;
+    glib_gl_state.blend_dst = dst;
+    glib_state_stats.issued++;
+}
+
+// the unknown parts of the state are read back once, after that the shadow state has them
+static glib_blend_state_t glib_save_blend_state(void){
+    if(glib_gl_state.blend==GLIB_STATE_UNKNOWN){
+        glib_gl_state.blend = glIsEnabled(GL_BLEND)?1:0;
+    }
+    if(glib_gl_state.depth_test==GLIB_STATE_UNKNOWN){
+        glib_gl_state.depth_test = glIsEnabled(GL_DEPTH_TEST)?1:0;
+    }
+    if(glib_gl_state.depth_mask==GLIB_STATE_UNKNOWN){
+        GLboolean mask = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &mask);
+        glib_gl_state.depth_mask = mask?1:0;
+    }
+    if(glib_gl_state.blend_src==GLIB_STATE_UNKNOWN || glib_gl_state.blend_dst==GLIB_STATE_UNKNOWN){
+        GLint src = GL_ONE, dst = GL_ZERO;
+        glGetIntegerv(GL_BLEND_SRC_RGB, &src);
+        glGetIntegerv(GL_BLEND_DST_RGB, &dst);
+        glib_gl_state.blend_src = (unsigned int)src;
+        glib_gl_state.blend_dst = (unsigned int)dst;
+    }
+    glib_blend_state_t state = {
+        glib_gl_state.blend==1, glib_gl_state.depth_test==1, glib_gl_state.depth_mask==1,
+        glib_gl_state.blend_src, glib_gl_state.blend_dst,
+    };
+    return state;
+}
+
+static void glib_restore_blend_state(const glib_blend_state_t* state){
+    glib_set_capability(&glib_gl_state.blend, GL_BLEND, state->blend);
+    glib_set_capability(&glib_gl_state.depth_test, GL_DEPTH_TEST, state->depth_test);
+    glib_set_depth_mask(state->depth_mask);
+    glib_set_blend_func(state->blend_src, state->blend_dst);
+}
+
+void glib_invalidate_state_cache(void){
+    glib_gl_state.program = GLIB_STATE_UNKNOWN;
+    glib_gl_state.active_unit = GLIB_STATE_UNKNOWN;
+    for(int i = 0; i<GLIB_TEX_SLOT_COUNT; i++){
+        glib_gl_state.textures[i] = GLIB_STATE_UNKNOWN;
+    }
+    glib_gl_state.VAO = GLIB_STATE_UNKNOWN;
+    glib_gl_state.polygon_mode = GLIB_STATE_UNKNOWN;
+    glib_gl_state.blend = GLIB_STATE_UNKNOWN;
+    glib_gl_state.depth_test = GLIB_STATE_UNKNOWN;
+    glib_gl_state.depth_mask = GLIB_STATE_UNKNOWN;
+    glib_gl_state.blend_src = GLIB_STATE_UNKNOWN;
+    glib_gl_state.blend_dst = GLIB_STATE_UNKNOWN;
+}
+
+glib_state_stats_t glib_get_state_stats(void){
+    return glib_state_stats;
+}
+
+void glib_reset_state_stats(void){
+    glib_state_stats.issued = 0;
+    glib_state_stats.skipped = 0;
+}
+
+char* glib_read_from_file(const char* file_name){
+    FILE *fp;
+    long size;
+    char *buffer;
+
+    fp = fopen ( file_name , "rb" );
+    if( !fp ) perror(file_name),exit(1);
+
+    fseek( fp , 0L , SEEK_END);
+    size = ftell( fp );
+    rewind( fp );
+
+    buffer = calloc( 1, size+1 );
+    if( !buffer ) fclose(fp),fputs("memory alloc fails",stderr),exit(1);
+
+    if( 1!=fread( buffer , size, 1 , fp) )
+        fclose(fp),free(buffer),fputs("entire read fails",stderr),exit(1);
+
+    fclose(fp);
+    return buffer;
+}
+
+static unsigned int glib_hash_str(const char* str){
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    while(*str){
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+typedef struct {
+    void* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} glib_mapped_file_t;
+
+// map a whole file read only, an empty file can't be mapped
+static bool glib_map_file(const char* file_name, glib_mapped_file_t* file){
+    memset(file, 0, sizeof(glib_mapped_file_t));
+#ifdef _WIN32
+    file->file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file->file==INVALID_HANDLE_VALUE){
+        return false;
+    }
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file->file, &size) || size.QuadPart==0){
+        CloseHandle(file->file);
+        return false;
+    }
+    file->mapping = CreateFileMappingA(file->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(!file->mapping){
+        CloseHandle(file->file);
+        return false;
+    }
+    file->data = MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!file->data){
+        CloseHandle(file->mapping);
+        CloseHandle(file->file);
+        return false;
+    }
+    file->size = (size_t)size.QuadPart;
+#else
+    int fd = open(file_name, O_RDONLY);
+    if(fd<0){
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st)!=0 || st.st_size==0){
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive
+    close(fd);
+    if(data==MAP_FAILED){
+        return false;
+    }
+    file->data = data;
+    file->size = st.st_size;
+#endif
+    return true;
+}
+
+// "<file_path><ext>", the caller frees it
+static char* glib_make_cache_path(const char* file_path, const char* ext){
+    char* cache_path = (char*)malloc(strlen(file_path)+strlen(ext)+1);
+    if(!cache_path) fputs("memory alloc fails",stderr),exit(1);
+    strcpy(cache_path, file_path);
+    strcat(cache_path, ext);
+    return cache_path;
+}
+
+static void glib_unmap_file(glib_mapped_file_t* file){
+    if(file->data==NULL){
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->mapping);
+    CloseHandle(file->file);
+#else
+    munmap(file->data, file->size);
+#endif
+    file->data = NULL;
+    file->size = 0;
+}
+
+// A pack is the header, the index sorted by path hash then path, the NUL terminated paths and the contents.
+// Every content is GLIB_PACK_ALIGNMENT aligned and followed by a NUL, so a packed text is a C string in the mapping
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int entry_count;
+    unsigned int reserved;
+} glib_pack_header_t;
+
+// 32 bytes
+typedef struct {
+    unsigned int hash;      // glib_hash_str of the path
+    unsigned int path_len;
+    unsigned long long path_offset;
+    unsigned long long data_offset;
+    unsigned long long data_size;
+} glib_pack_entry_t;
+
+glib_mapped_file_t glib_packs[GLIB_MAX_PACKS];
+unsigned int glib_pack_count = 0;
+
+static int glib_pack_compare(unsigned int hash_a, const char* path_a, unsigned int hash_b, const char* path_b){
+    if(hash_a!=hash_b){
+        return hash_a<hash_b?-1:1;
+    }
+    return strcmp(path_a, path_b);
+}
+
+bool glib_mount_pack(const char* file_path){
+    if(glib_pack_count==GLIB_MAX_PACKS){
+        fprintf(stderr, "[WARN] Too many mounted packs. %s\n", file_path);
+        return false;
+    }
+    glib_mapped_file_t file;
+    if(!glib_map_file(file_path, &file)){
+        return false;
+    }
+
+    // the index is checked once here, so the lookups can trust it
+    const char* base = (const char*)file.data;
+    const glib_pack_header_t* header = (const glib_pack_header_t*)base;
+    const glib_pack_entry_t* entries = (const glib_pack_entry_t*)(header+1);
+    bool valid = file.size>=sizeof(glib_pack_header_t) &&
+        header->magic==GLIB_PACK_MAGIC &&
+        header->version==GLIB_PACK_VERSION &&
+        header->entry_count<=(file.size-sizeof(glib_pack_header_t))/sizeof(glib_pack_entry_t);
+    for(unsigned int i = 0; valid && i<header->entry_count; i++){
+        const glib_pack_entry_t* entry = &entries[i];
+        valid = entry->path_offset<file.size && entry->path_len<file.size-entry->path_offset &&
+            base[entry->path_offset+entry->path_len]=='\0' &&
+            entry->data_offset<file.size && entry->data_size<file.size-entry->data_offset &&
+            base[entry->data_offset+entry->data_size]=='\0';
+        if(valid && i>0){
+            valid = glib_pack_compare(entries[i-1].hash, base+entries[i-1].path_offset, entry->hash, base+entry->path_offset)<0;
+        }
+    }
+    if(!valid){
+        fprintf(stderr, "[WARN] Invalid pack. %s\n", file_path);
+        glib_unmap_file(&file);
+        return false;
+    }
+    glib_packs[glib_pack_count++] = file;
+    return true;
+}
+
+void glib_unmount_packs(void){
+    for(unsigned int i = 0; i<glib_pack_count; i++){
+        glib_unmap_file(&glib_packs[i]);
+    }
+    glib_pack_count = 0;
+}
+
+const void* glib_find_packed(const char* path, size_t* size){
+    if(glib_pack_count==0){
+        return NULL;
+    }
+    unsigned int hash = glib_hash_str(path);
+    for(int p = (int)glib_pack_count-1; p>=0; p--){
+        const char* base = (const char*)glib_packs[p].data;
+        const glib_pack_header_t* header = (const glib_pack_header_t*)base;
+        const glib_pack_entry_t* entries = (const glib_pack_entry_t*)(header+1);
+
+        // the first entry of the hash, then the paths of the same hash
+        unsigned int lo = 0, hi = header->entry_count;
+        while(lo<hi){
+            unsigned int mid = lo+(hi-lo)/2;
+            if(entries[mid].hash<hash){
+                lo = mid+1;
+            }else{
+                hi = mid;
+            }
+        }
+        for(; lo<header->entry_count && entries[lo].hash==hash; lo++){
+            if(strcmp(base+entries[lo].path_offset, path)==0){
+                if(size){
+                    *size = entries[lo].data_size;
+                }
+                return base+entries[lo].data_offset;
+            }
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    const char* path;
+    unsigned int hash;
+} glib_pack_source_t;
+
+static int glib_pack_source_compare(const void* a, const void* b){
+    const glib_pack_source_t* sa = (const glib_pack_source_t*)a;
+    const glib_pack_source_t* sb = (const glib_pack_source_t*)b;
+    return glib_pack_compare(sa->hash, sa->path, sb->hash, sb->path);
+}
+
+static bool glib_write_padding(FILE* fp, size_t size){
+    static const unsigned char zeros[GLIB_PACK_ALIGNMENT] = {0};
+    return size==0 || fwrite(zeros, 1, size, fp)==size;
+}
+
+bool glib_write_pack(const char* pack_path, const char* const* file_paths, unsigned int file_count){
+    static const char* const cache_exts[] = {GLIB_MESH_CACHE_EXT, GLIB_TEXTURE_CACHE_EXT};
+    size_t capacity = (size_t)file_count*(1+GLIB_ARRAY_LEN(cache_exts));
+    glib_pack_source_t* sources = (glib_pack_source_t*)malloc(sizeof(glib_pack_source_t)*(capacity?capacity:1));
+    char** cache_paths = (char**)malloc(sizeof(char*)*(capacity?capacity:1));
+    if(!sources || !cache_paths) fputs("memory alloc fails",stderr),exit(1);
+    unsigned int count = 0;
+    unsigned int cache_count = 0;
+    for(unsigned int i = 0; i<file_count; i++){
+        sources[count].path = file_paths[i];
+        sources[count].hash = glib_hash_str(file_paths[i]);
+        count++;
+    }
+    // the current caches of the files go with them, unless they are given too
+    for(unsigned int i = 0; i<file_count; i++){
+        for(unsigned int e = 0; e<GLIB_ARRAY_LEN(cache_exts); e++){
+            char* cache_path = glib_make_cache_path(file_paths[i], cache_exts[e]);
+            bool listed = false;
+            for(unsigned int j = 0; j<file_count && !listed; j++){
+                listed = strcmp(file_paths[j], cache_path)==0;
+            }
+            if(listed || !glib_cache_is_current(file_paths[i], cache_path)){
+                free(cache_path);
+                continue;
+            }
+            cache_paths[cache_count++] = cache_path;
+            sources[count].path = cache_path;
+            sources[count].hash = glib_hash_str(cache_path);
+            count++;
+        }
+    }
+    glib_pack_entry_t* entries = (glib_pack_entry_t*)calloc(count?count:1, sizeof(glib_pack_entry_t));
+    if(!entries) fputs("memory alloc fails",stderr),exit(1);
+    qsort(sources, count, sizeof(glib_pack_source_t), glib_pack_source_compare);
+
+    // the layout is known from the file sizes before anything is written
+    bool ok = true;
+    size_t offset = sizeof(glib_pack_header_t)+sizeof(glib_pack_entry_t)*count;
+    for(unsigned int i = 0; i<count; i++){
+        entries[i].hash = sources[i].hash;
+        entries[i].path_len = strlen(sources[i].path);
+        entries[i].path_offset = offset;
+        offset += entries[i].path_len+1;
+    }
+    for(unsigned int i = 0; i<count && ok; i++){
+        struct stat st;
+        if(stat(sources[i].path, &st)!=0){
+            fprintf(stderr, "Failed to pack file. %s\n", sources[i].path);
+            ok = false;
+            break;
+        }
+        offset = (offset+GLIB_PACK_ALIGNMENT-1)&~(size_t)(GLIB_PACK_ALIGNMENT-1);
+        entries[i].data_offset = offset;
+        entries[i].data_size = st.st_size;
+        offset += st.st_size+1;
+    }
+
+    FILE* fp = ok?fopen(pack_path, "wb"):NULL;
+    if(fp){
+        glib_pack_header_t header = {GLIB_PACK_MAGIC, GLIB_PACK_VERSION, count, 0};
+        ok = fwrite(&header, sizeof(header), 1, fp)==1;
+        ok = ok && (count==0 || fwrite(entries, sizeof(glib_pack_entry_t), count, fp)==count);
+        for(unsigned int i = 0; i<count && ok; i++){
+            ok = fwrite(sources[i].path, 1, entries[i].path_len+1, fp)==entries[i].path_len+1;
+        }
+        size_t pos = sizeof(glib_pack_header_t)+sizeof(glib_pack_entry_t)*count;
+        for(unsigned int i = 0; i<count; i++){
+            pos += entries[i].path_len+1;
+        }
+        for(unsigned int i = 0; i<count && ok; i++){
+            ok = glib_write_padding(fp, entries[i].data_offset-pos);
+            if(ok && entries[i].data_size>0){
+                // the file has to be the same size as it was when the layout was made
+                glib_mapped_file_t file;
+                ok = glib_map_file(sources[i].path, &file) && file.size==entries[i].data_size &&
+                    fwrite(file.data, 1, file.size, fp)==file.size;
+                glib_unmap_file(&file);
+            }
+            ok = ok && glib_write_padding(fp, 1);
+            pos = entries[i].data_offset+entries[i].data_size+1;
+        }
+        ok = (fclose(fp)==0) && ok;
+        if(!ok){
+            remove(pack_path);
+        }
+    }else{
+        ok = false;
+    }
+    for(unsigned int i = 0; i<cache_count; i++){
+        free(cache_paths[i]);
+    }
+    free(cache_paths);
+    free(sources);
+    free(entries);
+    return ok;
+}
+
+typedef struct {
+    unsigned long long seq;         // index+1 of the event when it is completely written, 0 while it is written
+    const char* name;
+    unsigned long long start;       // microseconds since the profiler was enabled
+    unsigned long long duration;    // microseconds
+    unsigned long long frame;
+    unsigned int tid;               // 0 is the GPU track
+} glib_profile_event_t;
+
+typedef struct {
+    bool enabled;
+    glib_profile_event_t* events;
+    unsigned long long head;        // next event index, every thread reserves events with an atomic add
+    unsigned long long timer_start;
+    unsigned long long timer_frequency;
+    unsigned int next_tid;
+
+    // GPU scopes in flight from tail to head, each has a begin and an end GL_TIMESTAMP query, they are read in order when the scope is ended and its results are available
+    unsigned int queries[GLIB_PROFILER_GPU_QUERIES*2];
+    const char* query_names[GLIB_PROFILER_GPU_QUERIES];
+    unsigned long long query_starts[GLIB_PROFILER_GPU_QUERIES];
+    unsigned long long query_frames[GLIB_PROFILER_GPU_QUERIES];
+    bool query_ended[GLIB_PROFILER_GPU_QUERIES];
+    unsigned int query_head;
+    unsigned int query_tail;
+    bool queries_created;
+} glib_profiler_t;
+
+glib_profiler_t glib_profiler;
+static __thread unsigned int glib_profiler_thread_id;
+
+static unsigned long long glib_profiler_now(void){
+    unsigned long long ticks = glfwGetTimerValue()-glib_profiler.timer_start;
+    return (unsigned long long)((double)ticks*1000000.0/(double)glib_profiler.timer_frequency);
+}
+
+static unsigned int glib_profiler_tid(void){
+    if(glib_profiler_thread_id==0){
+        glib_profiler_thread_id = __atomic_add_fetch(&glib_profiler.next_tid, 1, __ATOMIC_RELAXED);
+    }
+    return glib_profiler_thread_id;
+}
+
+static void glib_profiler_push(const char* name, unsigned long long start, unsigned long long duration, unsigned long long frame, unsigned int tid){
+    unsigned long long index = __atomic_fetch_add(&glib_profiler.head, 1, __ATOMIC_RELAXED);
+    glib_profile_event_t* event = &glib_profiler.events[index&(GLIB_PROFILER_CAPACITY-1)];
+    __atomic_store_n(&event->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event->name = name;
+    event->start = start;
+    event->duration = duration;
+    event->frame = frame;
+    event->tid = tid;
+    __atomic_store_n(&event->seq, index+1, __ATOMIC_RELEASE);
+}
+
+void glib_profiler_enable(bool enabled){
+    if(enabled && !glib_profiler.events){
+        glib_profiler.events = (glib_profile_event_t*)calloc(GLIB_PROFILER_CAPACITY, sizeof(glib_profile_event_t));
+        if(!glib_profiler.events) fputs("memory alloc fails",stderr),exit(1);
+        glib_profiler.timer_start = glfwGetTimerValue();
+        glib_profiler.timer_frequency = glfwGetTimerFrequency();
+        // the thread which enables the profiler is the main thread in the trace
+        glib_profiler_tid();
+    }
+    glib_profiler.enabled = enabled;
+}
+
+bool glib_profiler_is_enabled(void){
+    return glib_profiler.enabled;
+}
+
+glib_profile_scope_t glib_profile_begin(const char* name, bool gpu){
+    glib_profile_scope_t scope = {NULL, 0, -1};
+    if(!glib_profiler.enabled){
+        return scope;
+    }
+    scope.name = name;
+    scope.start = glib_profiler_now();
+
+    // only the thread of the GL context can issue queries
+    if(gpu && glib_window && glfwGetCurrentContext()==glib_window &&
+        glib_profiler.query_head-glib_profiler.query_tail<GLIB_PROFILER_GPU_QUERIES){
+        if(!glib_profiler.queries_created){
+            glGenQueries(GLIB_PROFILER_GPU_QUERIES*2, glib_profiler.queries);
+            glib_profiler.queries_created = true;
+        }
+        unsigned int slot = glib_profiler.query_head%GLIB_PROFILER_GPU_QUERIES;
+        glib_profiler.query_names[slot] = name;
+        glib_profiler.query_starts[slot] = scope.start;
+        glib_profiler.query_frames[slot] = glib_frame.frame_count;
+        glib_profiler.query_ended[slot] = false;
+        glQueryCounter(glib_profiler.queries[slot*2], GL_TIMESTAMP);
+        glib_profiler.query_head++;
+        scope.gpu_query = slot;
+    }
+    return scope;
+}
+
+void glib_profile_end(glib_profile_scope_t scope){
+    if(scope.gpu_query>=0){
+        glQueryCounter(glib_profiler.queries[scope.gpu_query*2+1], GL_TIMESTAMP);
+        glib_profiler.query_ended[scope.gpu_query] = true;
+    }
+    if(scope.name && glib_profiler.events){
+        glib_profiler_push(scope.name, scope.start, glib_profiler_now()-scope.start, glib_frame.frame_count, glib_profiler_tid());
+    }
+}
+
+void glib_profiler_collect(void){
+    while(glib_profiler.query_tail!=glib_profiler.query_head){
+        unsigned int slot = glib_profiler.query_tail%GLIB_PROFILER_GPU_QUERIES;
+        // an outer scope which is still open holds back the scopes after it
+        if(!glib_profiler.query_ended[slot]){
+            break;
+        }
+        // the end timestamp is written after the begin one
+        GLint available = 0;
+        glGetQueryObjectiv(glib_profiler.queries[slot*2+1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available){
+            break;
+        }
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(glib_profiler.queries[slot*2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(glib_profiler.queries[slot*2+1], GL_QUERY_RESULT, &end);
+        // the GPU work is shown from the CPU start of the scope, the GPU may run it later
+        glib_profiler_push(glib_profiler.query_names[slot], glib_profiler.query_starts[slot], end>begin?(end-begin)/1000:0, glib_profiler.query_frames[slot], 0);
+        glib_profiler.query_tail++;
+    }
+}
+
+static void glib_write_json_string(FILE* fp, const char* str){
+    fputc('"', fp);
+    for(; *str; str++){
+        unsigned char c = (unsigned char)*str;
+        if(c=='"' || c=='\\'){
+            fputc('\\', fp);
+            fputc(c, fp);
+        }else if(c<0x20){
+            fprintf(fp, "\\u%04x", c);
+        }else{
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+bool glib_profiler_write_trace(const char* file_path){
+    if(!glib_profiler.events){
+        return false;
+    }
+    FILE* fp = fopen(file_path, "w");
+    if(!fp){
+        return false;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}},\n");
+    fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Main\"}}");
+
+    unsigned long long head = __atomic_load_n(&glib_profiler.head, __ATOMIC_ACQUIRE);
+    unsigned long long first = head>GLIB_PROFILER_CAPACITY?head-GLIB_PROFILER_CAPACITY:0;
+    for(unsigned long long index = first; index<head; index++){
+        glib_profile_event_t* slot = &glib_profiler.events[index&(GLIB_PROFILER_CAPACITY-1)];
+        // the event is copied and kept only if no thread rewrote it meanwhile
+        if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE)!=index+1){
+            continue;
+        }
+        glib_profile_event_t event = *slot;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED)!=index+1){
+            continue;
+        }
+        fprintf(fp, ",\n{\"name\":");
+        glib_write_json_string(fp, event.name);
+        fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%llu}}",
+            event.tid==0?"gpu":"cpu", event.start, event.duration, event.tid, event.frame);
+    }
+    fprintf(fp, "\n]}\n");
+    return fclose(fp)==0;
+}
+
+void glib_init(void){
+    if(!glfwInit()){
+        fprintf(stderr, "ERROR: cannot init glfw\n");
+        exit(-1);
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    printf("[INFO] %s\n", glfwGetVersionString());
+    int nrAttributes;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &nrAttributes);
+    printf("[INFO] Maximum nr of vertex attributes supported: %zu\n", nrAttributes);
+}
+
+static void glib_framebuff_resize(GLFWwindow* window, int width, int height){
+    glViewport(0, 0, width, height);
+    if(glib_framebuffer_resize_fun!=NULL){
+        glib_framebuffer_resize_fun(width, height);
+    }
+    glib_window_width = width;
+    glib_window_height = height;
+}
+
+// the GLFW callbacks write the events, the readers take them with a CAS on the tail, both sides are lock-free
+typedef struct {
+    glib_input_event_t events[GLIB_INPUT_QUEUE_SIZE];
+    unsigned long long head;
+    unsigned long long tail;
+    unsigned long long dropped;
+} glib_input_queue_t;
+
+glib_input_queue_t glib_input_queue;
+
+static void glib_push_input_event(glib_input_type type, int code, int action, int mods){
+    unsigned long long head = __atomic_load_n(&glib_input_queue.head, __ATOMIC_RELAXED);
+    unsigned long long tail = __atomic_load_n(&glib_input_queue.tail, __ATOMIC_ACQUIRE);
+    if(head-tail>=GLIB_INPUT_QUEUE_SIZE){
+        glib_input_queue.dropped++;
+        return;
+    }
+    glib_input_event_t* event = &glib_input_queue.events[head&(GLIB_INPUT_QUEUE_SIZE-1)];
+    event->type = type;
+    event->code = code;
+    event->action = (glib_input_action)action;
+    event->mods = mods;
+    event->x = glib_mouse_pos_x;
+    event->y = glib_mouse_pos_y;
+    event->time = glfwGetTime();
+    __atomic_store_n(&glib_input_queue.head, head+1, __ATOMIC_RELEASE);
+}
+
+unsigned int glib_drain_input_events(glib_input_event_t* events, unsigned int max_events){
+    unsigned long long tail = __atomic_load_n(&glib_input_queue.tail, __ATOMIC_ACQUIRE);
+    for(;;){
+        unsigned long long head = __atomic_load_n(&glib_input_queue.head, __ATOMIC_ACQUIRE);
+        unsigned int count = head-tail<max_events?(unsigned int)(head-tail):max_events;
+        for(unsigned int i = 0; i<count; i++){
+            events[i] = glib_input_queue.events[(tail+i)&(GLIB_INPUT_QUEUE_SIZE-1)];
+        }
+        // another reader took them meanwhile, read again from its tail
+        if(__atomic_compare_exchange_n(&glib_input_queue.tail, &tail, tail+count, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+            return count;
+        }
+    }
+}
+
+unsigned long long glib_get_dropped_input_events(void){
+    return glib_input_queue.dropped;
+}
+
+static void glib_clear_input_edges(int set){
+    memset(glib_keyboard_press_edge[set], 0, sizeof(glib_keyboard_press_edge[set]));
+    memset(glib_keyboard_release_edge[set], 0, sizeof(glib_keyboard_release_edge[set]));
+    memset(glib_mouse_press_edge[set], 0, sizeof(glib_mouse_press_edge[set]));
+    memset(glib_mouse_release_edge[set], 0, sizeof(glib_mouse_release_edge[set]));
+}
+
+// called before the events of a frame are polled: the frame edges start again and the undrained events are dropped.
+// The step edges are kept until an update step has seen them
+static void glib_begin_input_frame(void){
+    glib_clear_input_edges(GLIB_EDGES_FRAME);
+    __atomic_store_n(&glib_input_queue.tail, __atomic_load_n(&glib_input_queue.head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+static void glib_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods){
+    glib_push_input_event(GLIB_INPUT_KEY, key, action, mods);
+    // GLIB_KEY_UNKNOWN keys are only queued
+    if(key<0 || key>=GLIB_MAX_KEYBOARD_KEY_SUPPORTED){
+        return;
+    }
+    if(action==GLFW_PRESS){
+        glib_keyboard_pressed[key] = true;
+        glib_keyboard_press_edge[GLIB_EDGES_FRAME][key] = true;
+        glib_keyboard_press_edge[GLIB_EDGES_STEP][key] = true;
+    }else if(action==GLFW_RELEASE){
+        glib_keyboard_pressed[key] = false;
+        glib_keyboard_release_edge[GLIB_EDGES_FRAME][key] = true;
+        glib_keyboard_release_edge[GLIB_EDGES_STEP][key] = true;
+    }
+}
+
+static void glib_cursor_position_callback(GLFWwindow* window, double xpos, double ypos){
+    glib_mouse_pos_x = xpos;
+    glib_mouse_pos_y = ypos;
+    glib_push_input_event(GLIB_INPUT_CURSOR, 0, 0, 0);
+}
+
+static void glib_mouse_button_callback(GLFWwindow* window, int button, int action, int mods){
+    glib_push_input_event(GLIB_INPUT_MOUSE_BUTTON, button, action, mods);
+    if(button<0 || button>=GLIB_MAX_MOUSE_BUTTON_SUPPORTED){
+        return;
+    }
+    if(action==GLFW_PRESS){
+        glib_mouse_pressed[button] = true;
+        glib_mouse_press_edge[GLIB_EDGES_FRAME][button] = true;
+        glib_mouse_press_edge[GLIB_EDGES_STEP][button] = true;
+        if(!glib_mouse_dragging){
+            glib_mouse_dragging = true;
+            glib_mouse_drag_button = button;
+        }
+    }else if(action==GLFW_RELEASE){
+        glib_mouse_pressed[button] = false;
+        glib_mouse_release_edge[GLIB_EDGES_FRAME][button] = true;
+        glib_mouse_release_edge[GLIB_EDGES_STEP][button] = true;
+        if(button==glib_mouse_drag_button){
+            glib_mouse_dragging = false;
+        }
+    }
+}
+
+static void glib_setup_window(int width, int height, const char* title, bool visible){
+    glfwWindowHint(GLFW_VISIBLE, visible?GLFW_TRUE:GLFW_FALSE);
+    glib_window = glfwCreateWindow(width, height, title, NULL, NULL);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if(!glib_window){
+        fprintf(stderr, "ERROR: cannot create window\n");
+        exit(-1);
+    }
+
+    glfwMakeContextCurrent(glib_window);
+    GLenum err = glewInit();
+    if (GLEW_OK != err){
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        exit(-1);
+    }
+
+    glib_invalidate_state_cache();
+    if(glib_frame.has_swap_interval){
+        glfwSwapInterval(glib_frame.swap_interval);
+    }
+
+    glfwSetFramebufferSizeCallback(glib_window, glib_framebuff_resize);
+    glib_window_width = width;
+    glib_window_height = height;
+
+    glfwSetKeyCallback(glib_window, glib_key_callback);
+    glfwSetCursorPosCallback(glib_window, glib_cursor_position_callback);
+    glfwSetMouseButtonCallback(glib_window, glib_mouse_button_callback);
+    
+    glib_default_shader = glib_create_shader_from_memory(glib_default_vert, glib_default_frag);
+
+    // without a camera the default shader draws in normalized device coords
+    mat4 identity;
+    glm_mat4_identity(identity);
+    glib_use_shader(glib_default_shader);
+    glib_set_unifrom_mat4(glib_default_shader, "model", identity);
+    glib_set_unifrom_mat4(glib_default_shader, "view", identity);
+    glib_set_unifrom_mat4(glib_default_shader, "proj", identity);
+
+    glib_default_instanced_shader = glib_create_shader_from_memory(glib_default_instanced_vert, glib_default_frag);
+    glib_use_shader(glib_default_instanced_shader);
+    glib_set_unifrom_mat4(glib_default_instanced_shader, "model", identity);
+    glib_set_unifrom_mat4(glib_default_instanced_shader, "view", identity);
+    glib_set_unifrom_mat4(glib_default_instanced_shader, "proj", identity);
+
+    // glib_flush_text sets the projection from the window size
+    glib_text_shader = glib_create_shader_from_memory(glib_default_vert, glib_text_frag);
+    glib_use_shader(glib_text_shader);
+    glib_set_unifrom_mat4(glib_text_shader, "model", identity);
+    glib_set_unifrom_mat4(glib_text_shader, "view", identity);
+    glib_use_shader(glib_default_shader);
+
+    glib_default_tex = glib_load_texture_2d_from_memory(glib_default_tex_jpg_raw, GLIB_ARRAY_LEN(glib_default_tex_jpg_raw), 0);
+    glib_set_capability(&glib_gl_state.depth_test, GL_DEPTH_TEST, true);
+}
+
+void glib_create_window(int width, int height, const char* title){
+    glib_setup_window(width, height, title, true);
+}
+
+typedef struct {
+    bool enabled;
+    unsigned int FBO;
+    unsigned int color_RBO;
+    unsigned int depth_RBO;
+    int width;
+    int height;
+    unsigned long long frame_limit; // 0 means no limit
+} glib_headless_t;
+
+glib_headless_t glib_headless;
+
+// frames read into pixel pack buffers, from tail to head, they are mapped when their fence is signaled
+typedef struct {
+    void (*fun)(const unsigned char* pixels, int width, int height, unsigned long long frame);
+    unsigned int PBOs[GLIB_READBACK_BUFFERS];
+    GLsync fences[GLIB_READBACK_BUFFERS];
+    int widths[GLIB_READBACK_BUFFERS];
+    int heights[GLIB_READBACK_BUFFERS];
+    unsigned long long frames[GLIB_READBACK_BUFFERS];
+    unsigned int head;
+    unsigned int tail;
+    bool created;
+} glib_readback_t;
+
+glib_readback_t glib_readback;
+
+void glib_create_headless(int width, int height){
+    glib_setup_window(width, height, "GLib headless", false);
+
+    glGenFramebuffers(1, &glib_headless.FBO);
+    glGenRenderbuffers(1, &glib_headless.color_RBO);
+    glGenRenderbuffers(1, &glib_headless.depth_RBO);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, glib_headless.color_RBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, glib_headless.depth_RBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, glib_headless.FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, glib_headless.color_RBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, glib_headless.depth_RBO);
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER)!=GL_FRAMEBUFFER_COMPLETE){
+        fprintf(stderr, "ERROR: cannot create the headless framebuffer\n");
+        exit(-1);
+    }
+    glViewport(0, 0, width, height);
+
+    glib_headless.enabled = true;
+    glib_headless.width = width;
+    glib_headless.height = height;
+}
+
+bool glib_is_headless(void){
+    return glib_headless.enabled;
+}
+
+void glib_set_frame_limit(unsigned long long frames){
+    glib_headless.frame_limit = frames;
+}
+
+void glib_stop(void){
+    glfwSetWindowShouldClose(glib_window, 1);
+}
+
+void glib_set_readback_callback(void (*readback_fun)(const unsigned char* pixels, int width, int height, unsigned long long frame)){
+    glib_readback.fun = readback_fun;
+}
+
+static void glib_readback_map(unsigned int slot){
+    glDeleteSync(glib_readback.fences[slot]);
+    glib_readback.fences[slot] = NULL;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, glib_readback.PBOs[slot]);
+    size_t size = (size_t)glib_readback.widths[slot]*glib_readback.heights[slot]*4;
+    const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if(pixels){
+        if(glib_readback.fun){
+            glib_readback.fun(pixels, glib_readback.widths[slot], glib_readback.heights[slot], glib_readback.frames[slot]);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// hands the finished frames to the callback, it waits only if wait is set
+static void glib_readback_collect(bool wait){
+    while(glib_readback.tail!=glib_readback.head){
+        unsigned int slot = glib_readback.tail%GLIB_READBACK_BUFFERS;
+        GLenum status = glClientWaitSync(glib_readback.fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, wait?GL_TIMEOUT_IGNORED:0);
+        if(status==GL_TIMEOUT_EXPIRED){
+            break;
+        }
+        glib_readback_map(slot);
+        glib_readback.tail++;
+    }
+}
+
+// starts the copy of the current frame into a pixel pack buffer, the pixels are read some frames later
+static void glib_readback_frame(void){
+    if(!glib_readback.created){
+        glGenBuffers(GLIB_READBACK_BUFFERS, glib_readback.PBOs);
+        glib_readback.created = true;
+    }
+    if(glib_readback.head-glib_readback.tail==GLIB_READBACK_BUFFERS){
+        // every buffer is in flight, the oldest one has to be finished
+        unsigned int slot = glib_readback.tail%GLIB_READBACK_BUFFERS;
+        glClientWaitSync(glib_readback.fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glib_readback_map(slot);
+        glib_readback.tail++;
+    }
+
+    int width, height;
+    if(glib_headless.enabled){
+        width = glib_headless.width;
+        height = glib_headless.height;
+    }else{
+        glfwGetFramebufferSize(glib_window, &width, &height);
+    }
+    unsigned int slot = glib_readback.head%GLIB_READBACK_BUFFERS;
+    glib_readback.widths[slot] = width;
+    glib_readback.heights[slot] = height;
+    glib_readback.frames[slot] = glib_frame.frame_count;
+
+    // the render function may have left its own framebuffer bound
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, glib_headless.enabled?glib_headless.FBO:0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, glib_readback.PBOs[slot]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)width*height*4, NULL, GL_STREAM_READ);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glib_readback.fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glib_readback.head++;
+}
+
+void glib_clear_color(float r, float g, float b, float a){
+    glClearColor(r, g, b, a);
+}
+
+void glib_set_render_callback(void (*render_fun)(void)){
+    glib_render_fun = render_fun;
+}
+
+void glib_set_framebuffer_resize_callback(void (*framebuffer_resize_fun)(int width, int height)){
+    glib_framebuffer_resize_fun =  framebuffer_resize_fun;
+}
+
+bool glib_is_keboard_pressed(int keycode){
+    if(keycode>=0 && keycode<GLIB_MAX_KEYBOARD_KEY_SUPPORTED){
+        return glib_keyboard_pressed[keycode];
+    }
+    return false;
+}
+
+bool glib_is_mouse_pressed(int mouse_button){
+    if(mouse_button>=0 && mouse_button<GLIB_MAX_MOUSE_BUTTON_SUPPORTED){
+        return glib_mouse_pressed[mouse_button];
+    }
+    return false;
+}
+
+bool glib_was_key_pressed(int keycode){
+    if(keycode>=0 && keycode<GLIB_MAX_KEYBOARD_KEY_SUPPORTED){
+        return glib_keyboard_press_edge[glib_input_edges][keycode];
+    }
+    return false;
+}
+
+bool glib_was_key_released(int keycode){
+    if(keycode>=0 && keycode<GLIB_MAX_KEYBOARD_KEY_SUPPORTED){
+        return glib_keyboard_release_edge[glib_input_edges][keycode];
+    }
+    return false;
+}
+
+bool glib_was_mouse_pressed(int mouse_button){
+    if(mouse_button>=0 && mouse_button<GLIB_MAX_MOUSE_BUTTON_SUPPORTED){
+        return glib_mouse_press_edge[glib_input_edges][mouse_button];
+    }
+    return false;
+}
+
+bool glib_was_mouse_released(int mouse_button){
+    if(mouse_button>=0 && mouse_button<GLIB_MAX_MOUSE_BUTTON_SUPPORTED){
+        return glib_mouse_release_edge[glib_input_edges][mouse_button];
+    }
+    return false;
+}
+
+bool glib_is_mouse_dragging(void){
+    return glib_mouse_dragging;
+}
+
+int glib_get_mouse_drag_button(void){
+    return glib_mouse_drag_button;
+}
+
+double glib_get_mouse_pos_x(void){
+    return (glib_mouse_pos_x/(double)glib_window_width)*2.0-1.0;
+}
+
+double glib_get_mouse_pos_y(void){
+    return (glib_mouse_pos_y/(double)glib_window_height)*2.0-1.0;
+}
+
+void glib_set_update_callback(void (*update_fun)(double dt)){
+    glib_update_fun = update_fun;
+}
+
+void glib_set_fixed_timestep(double dt){
+    glib_frame.fixed_timestep = dt>0.0?dt:GLIB_FIXED_TIMESTEP;
+}
+
+void glib_set_target_fps(double fps){
+    glib_frame.target_fps = fps>0.0?fps:0.0;
+}
+
+void glib_set_vsync(int interval){
+    glib_frame.swap_interval = interval;
+    glib_frame.has_swap_interval = true;
+    if(glib_window){
+        glfwSwapInterval(interval);
+    }
+}
+
+double glib_get_delta_time(void){
+    return glib_frame.delta;
+}
+
+double glib_get_time(void){
+    return glib_frame.time;
+}
+
+double glib_get_frame_alpha(void){
+    return glib_frame.alpha;
+}
+
+unsigned long long glib_get_frame_count(void){
+    return glib_frame.frame_count;
+}
+
+static void glib_sleep(double seconds){
+#ifdef _WIN32
+    Sleep((DWORD)(seconds*1000.0));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds-(double)ts.tv_sec)*1e9);
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// sleeps in short steps while the expected oversleep still fits before the deadline, then spins
+static void glib_wait_until(double deadline){
+    double now = glfwGetTime();
+    while(deadline-now>glib_frame.sleep_mean+glib_frame.sleep_dev){
+        glib_sleep(0.001);
+        double observed = glfwGetTime()-now;
+        now += observed;
+
+        // mean and deviation of one sleep step, exponentially weighted over the last ~1000 steps so it follows the scheduler
+        if(glib_frame.sleep_count<1000){
+            glib_frame.sleep_count++;
+        }
+        double weight = 1.0/glib_frame.sleep_count;
+        double delta = observed-glib_frame.sleep_mean;
+        glib_frame.sleep_mean += weight*delta;
+        glib_frame.sleep_var = (1.0-weight)*(glib_frame.sleep_var+weight*delta*delta);
+        glib_frame.sleep_dev = sqrt(glib_frame.sleep_var);
+    }
+    while(now<deadline){
+        now = glfwGetTime();
+    }
+}
+
+void glib_main_loop(void){
+    double start = glfwGetTime();
+    double previous = start;
+    double accumulator = 0.0;
+    double deadline = start;
+    while(!glfwWindowShouldClose(glib_window)){
+        if(glib_headless.frame_limit && glib_frame.frame_count>=glib_headless.frame_limit){
+            break;
+        }
+        double frame_start = glfwGetTime();
+        glib_frame.delta = frame_start-previous;
+        glib_frame.time = frame_start-start;
+        previous = frame_start;
+        glib_profile_scope_t frame_scope = glib_profile_begin("frame", false);
+
+        // the input of this frame is seen by the update and the render
+        glib_profile_scope_t scope = glib_profile_begin("poll events", false);
+        glib_begin_input_frame();
+        glfwPollEvents();
+        glib_profile_end(scope);
+
+        if(glib_update_fun!=NULL){
+            scope = glib_profile_begin("update", false);
+            // a long stall (e.g. dragging the window) would need too many steps to catch up
+            accumulator += glib_frame.delta>GLIB_MAX_FRAME_DELTA?GLIB_MAX_FRAME_DELTA:glib_frame.delta;
+            // every press is seen by exactly one step, the presses of a frame without a step wait for the next one
+            glib_input_edges = GLIB_EDGES_STEP;
+            while(accumulator>=glib_frame.fixed_timestep){
+                glib_update_fun(glib_frame.fixed_timestep);
+                glib_clear_input_edges(GLIB_EDGES_STEP);
+                accumulator -= glib_frame.fixed_timestep;
+            }
+            glib_input_edges = GLIB_EDGES_FRAME;
+            glib_frame.alpha = accumulator/glib_frame.fixed_timestep;
+            glib_profile_end(scope);
+        }
+
+        scope = glib_profile_begin("texture uploads", true);
+        glib_process_texture_uploads(glib_texture_upload_budget);
+        glib_profile_end(scope);
+
+        scope = glib_profile_begin("render", true);
+        if(glib_headless.enabled){
+            glBindFramebuffer(GL_FRAMEBUFFER, glib_headless.FBO);
+        }
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glib_use_texture_2d(glib_default_tex, GLIB_TEX_SLOT0);
+        glib_upload_camera();
+        glib_use_shader(glib_default_shader);
+        if(glib_render_fun!=NULL){
+            glib_render_fun();
+        }
+        glib_flush_render_queue();
+        glib_flush_text();
+        glib_profile_end(scope);
+
+        if(glib_readback.fun){
+            scope = glib_profile_begin("readback", false);
+            glib_readback_frame();
+            glib_readback_collect(false);
+            glib_profile_end(scope);
+        }
+
+        if(!glib_headless.enabled){
+            scope = glib_profile_begin("swap buffers", false);
+            glfwSwapBuffers(glib_window);
+            glib_profile_end(scope);
+        }
+        glib_profiler_collect();
+        glib_collect_garbage(false);
+        glib_profile_end(frame_scope);
+        glib_frame.frame_count++;
+
+        if(glib_frame.target_fps>0.0){
+            // the deadlines follow a fixed grid, so the error of one frame does not add up
+            deadline += 1.0/glib_frame.target_fps;
+            double now = glfwGetTime();
+            if(deadline<now){
+                deadline = now;
+            }else{
+                scope = glib_profile_begin("frame limiter", false);
+                glib_wait_until(deadline);
+                glib_profile_end(scope);
+            }
+        }else{
+            deadline = glfwGetTime();
+        }
+    }
+    glib_readback_collect(true);
+    glib_collect_garbage(true);
+    glib_stop_texture_workers();
+    glfwDestroyWindow(glib_window);
+    glfwTerminate();
+}
+
+static GLenum glib_gl_buffer_usage(glib_buffer_usage usage){
+    switch(usage){
+        case GLIB_BUFFER_DYNAMIC: return GL_DYNAMIC_DRAW;
+        case GLIB_BUFFER_STREAM: return GL_STREAM_DRAW;
+        default: return GL_STATIC_DRAW;
+    }
+}
+
+static GLenum glib_gl_attrib_type(glib_attrib_type type){
+    switch(type){
+        case GLIB_ATTRIB_HALF_FLOAT: return GL_HALF_FLOAT;
+        case GLIB_ATTRIB_BYTE: return GL_BYTE;
+        case GLIB_ATTRIB_UNSIGNED_BYTE: return GL_UNSIGNED_BYTE;
+        case GLIB_ATTRIB_SHORT: return GL_SHORT;
+        case GLIB_ATTRIB_UNSIGNED_SHORT: return GL_UNSIGNED_SHORT;
+        default: return GL_FLOAT;
+    }
+}
+
+static unsigned int glib_attrib_type_size(glib_attrib_type type){
+    switch(type){
+        case GLIB_ATTRIB_HALF_FLOAT: return 2;
+        case GLIB_ATTRIB_BYTE: return 1;
+        case GLIB_ATTRIB_UNSIGNED_BYTE: return 1;
+        case GLIB_ATTRIB_SHORT: return 2;
+        case GLIB_ATTRIB_UNSIGNED_SHORT: return 2;
+        default: return 4;
+    }
+}
+
+static unsigned int glib_index_size(glib_index_type type){
+    return type==GLIB_INDEX_UINT16?sizeof(unsigned short):sizeof(unsigned int);
+}
+
+glib_vertex_layout_t glib_default_vertex_layout(void){
+    glib_vertex_layout_t layout = {
+        .attribs = {
+            {0, 3, GLIB_ATTRIB_FLOAT, false, 0},
+            {1, 4, GLIB_ATTRIB_FLOAT, false, 3*sizeof(float)},
+            {2, 2, GLIB_ATTRIB_FLOAT, false, 7*sizeof(float)},
+        },
+        .attrib_count = 3,
+        .stride = GLIB_VERTEX_FLOAT_COUNT*sizeof(float),
+    };
+    return layout;
+}
+
+glib_vertex_layout_t glib_compact_vertex_layout(void){
+    glib_vertex_layout_t layout = {
+        .attribs = {
+            {0, 3, GLIB_ATTRIB_FLOAT, false, 0},
+            {1, 4, GLIB_ATTRIB_UNSIGNED_BYTE, true, 12},
+            {2, 2, GLIB_ATTRIB_HALF_FLOAT, false, 16},
+        },
+        .attrib_count = 3,
+        .stride = 20,
+    };
+    return layout;
+}
+
+static bool glib_is_default_vertex_layout(const glib_vertex_layout_t* layout){
+    glib_vertex_layout_t default_layout = glib_default_vertex_layout();
+    if(layout->stride!=default_layout.stride || layout->attrib_count!=default_layout.attrib_count){
+        return false;
+    }
+    for(unsigned int i = 0; i<layout->attrib_count; i++){
+        const glib_vertex_attrib_t* a = &layout->attribs[i];
+        const glib_vertex_attrib_t* b = &default_layout.attribs[i];
+        if(a->location!=b->location || a->size!=b->size || a->type!=b->type || a->normalized!=b->normalized || a->offset!=b->offset){
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned short glib_float_to_half(float value){
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    unsigned int sign = (bits>>16)&0x8000u;
+    int exponent = (int)((bits>>23)&0xFF)-127+15;
+    unsigned int mantissa = bits&0x7FFFFFu;
+
+    if(((bits>>23)&0xFF)==0xFF){
+        // inf and nan
+        return (unsigned short)(sign|0x7C00u|(mantissa?0x200u:0));
+    }
+    if(exponent>=31){
+        return (unsigned short)(sign|0x7C00u);
+    }
+    if(exponent<=0){
+        // denormals, too small values become zero
+        if(exponent<-10){
+            return (unsigned short)sign;
+        }
+        mantissa |= 0x800000u;
+        unsigned int shift = 14-exponent;
+        unsigned int half = mantissa>>shift;
+        // round to nearest even
+        unsigned int rest = mantissa&((1u<<shift)-1);
+        unsigned int halfway = 1u<<(shift-1);
+        if(rest>halfway || (rest==halfway && (half&1))){
+            half++;
+        }
+        return (unsigned short)(sign|half);
+    }
+    unsigned int half = sign|((unsigned int)exponent<<10)|(mantissa>>13);
+    unsigned int rest = mantissa&0x1FFFu;
+    if(rest>0x1000u || (rest==0x1000u && (half&1))){
+        // it may carry into the exponent, which is still the correct rounding
+        half++;
+    }
+    return (unsigned short)half;
+}
+
+// static objects has one copy of the vertices, the others has GLIB_BUFFER_RING_SIZE copies
+static unsigned int glib_obj_ring_size(glib_obj_t* obj){
+    return obj->usage==GLIB_BUFFER_STATIC?1:GLIB_BUFFER_RING_SIZE;
+}
+
+static GLint glib_obj_base_vertex(glib_obj_t* obj){
+    return obj->ring_index*obj->vertex_capacity;
+}
+
+static GLintptr glib_obj_region_start(glib_obj_t* obj){
+    return (GLintptr)obj->vertex_capacity*obj->layout.stride*obj->ring_index;
+}
+
+// objects without a position attribute are never culled
+#define GLIB_UNBOUNDED 1e18f
+
+static float glib_half_to_float(unsigned short half){
+    unsigned int sign = (unsigned int)(half&0x8000u)<<16;
+    unsigned int exponent = (half>>10)&0x1F;
+    unsigned int mantissa = half&0x3FFu;
+    unsigned int bits;
+    if(exponent==0){
+        // zero and denormals
+        float value = (float)mantissa*(1.0f/16777216.0f);
+        return sign?-value:value;
+    }else if(exponent==31){
+        bits = sign|0x7F800000u|(mantissa<<13);
+    }else{
+        bits = sign|((exponent-15+127)<<23)|(mantissa<<13);
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static float glib_read_attrib_component(const unsigned char* p, const glib_vertex_attrib_t* attrib, int component){
+    switch(attrib->type){
+        case GLIB_ATTRIB_FLOAT: {
+            float v;
+            memcpy(&v, p+component*sizeof(float), sizeof(v));
+            return v;
+        }
+        case GLIB_ATTRIB_HALF_FLOAT: {
+            unsigned short v;
+            memcpy(&v, p+component*sizeof(v), sizeof(v));
+            return glib_half_to_float(v);
+        }
+        case GLIB_ATTRIB_BYTE: {
+            float v = ((const signed char*)p)[component];
+            return attrib->normalized?fmaxf(v/127.0f, -1.0f):v;
+        }
+        case GLIB_ATTRIB_UNSIGNED_BYTE: {
+            float v = p[component];
+            return attrib->normalized?v/255.0f:v;
+        }
+        case GLIB_ATTRIB_SHORT: {
+            short s;
+            memcpy(&s, p+component*sizeof(s), sizeof(s));
+            return attrib->normalized?fmaxf(s/32767.0f, -1.0f):(float)s;
+        }
+        case GLIB_ATTRIB_UNSIGNED_SHORT: {
+            unsigned short s;
+            memcpy(&s, p+component*sizeof(s), sizeof(s));
+            return attrib->normalized?s/65535.0f:(float)s;
+        }
+    }
+    return 0.0f;
+}
+
+static const glib_vertex_attrib_t* glib_position_attrib(const glib_vertex_layout_t* layout){
+    for(unsigned int i = 0; i<layout->attrib_count; i++){
+        if(layout->attribs[i].location==0){
+            return &layout->attribs[i];
+        }
+    }
+    return NULL;
+}
+
+// grows the bounds with the positions which are completely in [offset, offset+size) of the vertex data, data points to offset
+static void glib_obj_extend_bounds(glib_obj_t* obj, const void* data, size_t offset, size_t size){
+    const glib_vertex_attrib_t* position = glib_position_attrib(&obj->layout);
+    if(position==NULL){
+        return;
+    }
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t stride = obj->layout.stride;
+    size_t position_size = (size_t)position->size*glib_attrib_type_size(position->type);
+    int components = position->size<3?position->size:3;
+    for(size_t v = offset/stride; v*stride<offset+size; v++){
+        size_t start = v*stride+position->offset;
+        if(start<offset || start+position_size>offset+size){
+            continue;
+        }
+        const unsigned char* p = bytes+(start-offset);
+        for(int c = 0; c<3; c++){
+            float value = c<components?glib_read_attrib_component(p, position, c):0.0f;
+            obj->bounds_min[c] = fminf(obj->bounds_min[c], value);
+            obj->bounds_max[c] = fmaxf(obj->bounds_max[c], value);
+        }
+    }
+}
+
+static void glib_obj_compute_bounds(glib_obj_t* obj, const void* vertices, unsigned int vertex_count){
+    if(glib_position_attrib(&obj->layout)==NULL){
+        glm_vec3_copy((vec3){-GLIB_UNBOUNDED, -GLIB_UNBOUNDED, -GLIB_UNBOUNDED}, obj->bounds_min);
+        glm_vec3_copy((vec3){GLIB_UNBOUNDED, GLIB_UNBOUNDED, GLIB_UNBOUNDED}, obj->bounds_max);
+        return;
+    }
+    glm_vec3_copy((vec3){GLIB_UNBOUNDED, GLIB_UNBOUNDED, GLIB_UNBOUNDED}, obj->bounds_min);
+    glm_vec3_copy((vec3){-GLIB_UNBOUNDED, -GLIB_UNBOUNDED, -GLIB_UNBOUNDED}, obj->bounds_max);
+    if(vertices){
+        glib_obj_extend_bounds(obj, vertices, 0, (size_t)vertex_count*obj->layout.stride);
+    }
+    if(obj->bounds_min[0]>obj->bounds_max[0]){
+        // no vertices
+        glm_vec3_copy((vec3){0.0f, 0.0f, 0.0f}, obj->bounds_min);
+        glm_vec3_copy((vec3){0.0f, 0.0f, 0.0f}, obj->bounds_max);
+    }
+}
+
+static glib_obj_t* glib_create_obj_buffers(const void* vertices, unsigned int vertex_count, const glib_vertex_layout_t* layout, const void* indices, unsigned int index_count, glib_index_type index_type, glib_buffer_usage usage){
+    if(layout->attrib_count>GLIB_MAX_VERTEX_ATTRIBS || layout->stride==0){
+        fprintf(stderr, "ERROR: invalid vertex layout\n");
+        exit(-1);
+    }
+    glib_obj_t* obj = glib_alloc_obj();
+    obj->layout = *layout;
+    obj->index_type = index_type;
+    obj->usage = usage;
+    obj->ring_index = 0;
+    obj->vertex_count = vertex_count;
+    obj->vertex_capacity = vertex_count;
+    obj->index_capacity = index_count;
+    for(int i = 0; i<GLIB_BUFFER_RING_SIZE; i++){
+        obj->fences[i] = NULL;
+    }
+
+    unsigned int VAO, VBO, EBO = 0;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    if(indices){
+        glGenBuffers(1, &EBO);
+    }
+
+    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
+    glib_bind_vao(VAO);
+
+    size_t vertices_size = (size_t)vertex_count*layout->stride;
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if(glib_obj_ring_size(obj)==1){
+        glBufferData(GL_ARRAY_BUFFER, vertices_size, vertices, GL_STATIC_DRAW);
+    }else{
+        // the first region gets the vertices, the others are filled by the updates
+        glBufferData(GL_ARRAY_BUFFER, vertices_size*GLIB_BUFFER_RING_SIZE, NULL, glib_gl_buffer_usage(usage));
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_size, vertices);
+    }
+
+    if(indices){
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (size_t)glib_index_size(index_type)*index_count, indices, glib_gl_buffer_usage(usage));
+    }
+
+    for(unsigned int i = 0; i<layout->attrib_count; i++){
+        const glib_vertex_attrib_t* attrib = &layout->attribs[i];
+        glVertexAttribPointer(attrib->location, attrib->size, glib_gl_attrib_type(attrib->type), attrib->normalized?GL_TRUE:GL_FALSE, layout->stride, (void*)(size_t)attrib->offset);
+        glEnableVertexAttribArray(attrib->location);
+    }
+
+    // note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    // remember: do NOT unbind the EBO while a VAO is active as the bound element buffer object IS stored in the VAO; keep the EBO bound.
+    //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glib_bind_vao(0);
+    obj->VAO = VAO;
+    obj->VBO = VBO;
+    obj->EBO = EBO;
+    obj->vertices = (float*)vertices;
+    obj->vertex_len = vertices_size/sizeof(float);
+    obj->indices = (unsigned int*)indices;
+    obj->index_len = index_count;
+    obj->instance_VBO = 0;
+    obj->instance_count = 0;
+    obj->instance_capacity = 0;
+    glib_obj_compute_bounds(obj, vertices, vertex_count);
+    return obj;
+}
+
+glib_obj_t* glib_create_obj(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len){
+    glib_vertex_layout_t layout = glib_default_vertex_layout();
+    return glib_create_obj_buffers(vertices, vertices_len/GLIB_VERTEX_FLOAT_COUNT, &layout, indices, indices_len, GLIB_INDEX_UINT32, GLIB_BUFFER_STATIC);
+}
+
+glib_obj_t* glib_create_obj_from_vert(float* vertices, unsigned int vertices_len){
+    glib_vertex_layout_t layout = glib_default_vertex_layout();
+    return glib_create_obj_buffers(vertices, vertices_len/GLIB_VERTEX_FLOAT_COUNT, &layout, NULL, 0, GLIB_INDEX_UINT32, GLIB_BUFFER_STATIC);
+}
+
+glib_obj_t* glib_create_obj_with_usage(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len, glib_buffer_usage usage){
+    glib_vertex_layout_t layout = glib_default_vertex_layout();
+    return glib_create_obj_buffers(vertices, vertices_len/GLIB_VERTEX_FLOAT_COUNT, &layout, indices, indices_len, GLIB_INDEX_UINT32, usage);
+}
+
+glib_obj_t* glib_create_obj_with_layout(const void* vertices, unsigned int vertex_count, const glib_vertex_layout_t* layout, const void* indices, unsigned int index_count, glib_index_type index_type, glib_buffer_usage usage){
+    return glib_create_obj_buffers(vertices, vertex_count, layout, indices, index_count, index_type, usage);
+}
+
+// fence the region which was drawn until now and step to the next one, waiting only if the GPU still reads it
+static void glib_obj_advance_ring(glib_obj_t* obj){
+    if(obj->fences[obj->ring_index]){
+        glDeleteSync(obj->fences[obj->ring_index]);
+    }
+    obj->fences[obj->ring_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    obj->ring_index = (obj->ring_index+1)%GLIB_BUFFER_RING_SIZE;
+
+    GLsync fence = obj->fences[obj->ring_index];
+    if(fence){
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while(glClientWaitSync(fence, flags, 1000000)==GL_TIMEOUT_EXPIRED){
+            flags = 0;
+        }
+        glDeleteSync(fence);
+        obj->fences[obj->ring_index] = NULL;
+    }
+}
+
+static void glib_obj_write_region(glib_obj_t* obj, size_t offset, const void* data, size_t size){
+    GLintptr start = glib_obj_region_start(obj)+offset;
+    // the region is not used by the GPU any more, so the driver does not have to synchronize
+    void* dst = glMapBufferRange(GL_ARRAY_BUFFER, start, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if(dst){
+        memcpy(dst, data, size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }else{
+        glBufferSubData(GL_ARRAY_BUFFER, start, size, data);
+    }
+}
+
+void glib_update_obj_vertex_data(glib_obj_t* obj, const void* vertices, unsigned int vertex_count){
+    size_t size = (size_t)vertex_count*obj->layout.stride;
+    glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+    if(vertex_count>obj->vertex_capacity){
+        // new storage, the old one is released by the driver when the GPU is done with it
+        for(int i = 0; i<GLIB_BUFFER_RING_SIZE; i++){
+            if(obj->fences[i]){
+                glDeleteSync(obj->fences[i]);
+                obj->fences[i] = NULL;
+            }
+        }
+        obj->vertex_capacity = vertex_count;
+        obj->ring_index = 0;
+        glBufferData(GL_ARRAY_BUFFER, size*glib_obj_ring_size(obj), NULL, glib_gl_buffer_usage(obj->usage));
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices);
+    }else if(obj->usage==GLIB_BUFFER_STATIC){
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices);
+    }else{
+        glib_obj_advance_ring(obj);
+        glib_obj_write_region(obj, 0, vertices, size);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if((const void*)obj->vertices!=vertices){
+        if(obj->owns_vertices){
+            free(obj->vertices);
+        }
+        obj->owns_vertices = false;
+    }
+    obj->vertices = (float*)vertices;
+    obj->vertex_count = vertex_count;
+    obj->vertex_len = size/sizeof(float);
+    glib_obj_compute_bounds(obj, vertices, vertex_count);
+}
+
+static void glib_update_obj_bytes(glib_obj_t* obj, size_t offset, const void* data, size_t size){
+    size_t used = (size_t)obj->vertex_count*obj->layout.stride;
+    if(offset+size>used){
+        fprintf(stderr, "ERROR: the updated range [%llu, %llu) is out of the object's vertices (%llu bytes)\n", (unsigned long long)offset, (unsigned long long)(offset+size), (unsigned long long)used);
+        exit(-1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+    if(obj->usage==GLIB_BUFFER_STATIC){
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }else{
+        GLintptr prev_start = glib_obj_region_start(obj);
+        glib_obj_advance_ring(obj);
+        GLintptr start = glib_obj_region_start(obj);
+
+        // the untouched vertices are copied on the GPU from the previous region, around the written range
+        glBindBuffer(GL_COPY_READ_BUFFER, obj->VBO);
+        if(offset>0){
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, prev_start, start, offset);
+        }
+        if(offset+size<used){
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, prev_start+offset+size, start+offset+size, used-offset-size);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glib_obj_write_region(obj, offset, data, size);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // the bounds only grow, the old positions of the range may still be in them
+    glib_obj_extend_bounds(obj, data, offset, size);
+}
+
+void glib_update_obj_vertex_data_range(glib_obj_t* obj, unsigned int first_vertex, const void* vertices, unsigned int vertex_count){
+    glib_update_obj_bytes(obj, (size_t)first_vertex*obj->layout.stride, vertices, (size_t)vertex_count*obj->layout.stride);
+}
+
+void glib_update_obj_vertices(glib_obj_t* obj, float* vertices, unsigned int vertices_len){
+    glib_update_obj_vertex_data(obj, vertices, sizeof(float)*vertices_len/obj->layout.stride);
+}
+
+void glib_update_obj_vertices_range(glib_obj_t* obj, unsigned int offset, const float* vertices, unsigned int len){
+    glib_update_obj_bytes(obj, sizeof(float)*offset, vertices, sizeof(float)*len);
+}
+
+void glib_update_obj_index_data(glib_obj_t* obj, const void* indices, unsigned int index_count){
+    size_t index_size = glib_index_size(obj->index_type);
+    // the element buffer binding is part of the VAO
+    glib_bind_vao(obj->VAO);
+    if(obj->EBO==0){
+        unsigned int EBO;
+        glGenBuffers(1, &EBO);
+        obj->EBO = EBO;
+        obj->index_capacity = 0;
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj->EBO);
+    // the LODs are built from the old indices
+    obj->lod_count = 0;
+    obj->lod = 0;
+    if(index_count>obj->index_capacity){
+        obj->index_capacity = index_count;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size*index_count, indices, glib_gl_buffer_usage(obj->usage));
+    }else{
+        // orphaning, the draws which still read the old indices keep the old storage
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size*obj->index_capacity, NULL, glib_gl_buffer_usage(obj->usage));
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, index_size*index_count, indices);
+    }
+    if((const void*)obj->indices!=indices){
+        if(obj->owns_indices){
+            free(obj->indices);
+        }
+        obj->owns_indices = false;
+    }
+    obj->indices = (unsigned int*)indices;
+    obj->index_len = index_count;
+}
+
+void glib_update_obj_indices(glib_obj_t* obj, unsigned int* indices, unsigned int indices_len){
+    if(obj->index_type!=GLIB_INDEX_UINT32){
+        fprintf(stderr, "ERROR: glib_update_obj_indices needs 32 bit indices, use glib_update_obj_index_data\n");
+        exit(-1);
+    }
+    glib_update_obj_index_data(obj, indices, indices_len);
+}
+
+// the shape helpers build their vertices on the stack, so the object gets its own copy
+static glib_obj_t* glib_create_obj_copy(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len){
+    glib_obj_t* obj = glib_create_obj(vertices, vertices_len, indices, indices_len);
+    obj->vertices = (float*)malloc(sizeof(float)*vertices_len);
+    obj->indices = (unsigned int*)malloc(sizeof(unsigned int)*indices_len);
+    if(!obj->vertices || !obj->indices) fputs("memory alloc fails",stderr),exit(1);
+    memcpy(obj->vertices, vertices, sizeof(float)*vertices_len);
+    memcpy(obj->indices, indices, sizeof(unsigned int)*indices_len);
+    obj->owns_vertices = true;
+    obj->owns_indices = true;
+    return obj;
+}
+
+glib_obj_t* glib_create_triangle_obj(float x1, float y1, float x2, float y2, float x3, float y3){
+    float vertices[] = {
+        x1, y1, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x1, y1,
+        x2, y2, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x2, y2,
+        x3, y3, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x3, y3,
+    };
+    
+    unsigned int indices[] = {
+        0, 1, 2
+    };
+
+    return glib_create_obj_copy(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+}
+glib_obj_t* glib_create_triangle_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, int rgba_hex){
+    float vertices[] = {
+        x1, y1, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x1, y1,
+        x2, y2, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x2, y2,
+        x3, y3, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x3, y3,
+    };
+    
+    unsigned int indices[] = {
+        0, 1, 2
+    };
+
+    return glib_create_obj_copy(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+}
+
+glib_obj_t* glib_create_quad_obj(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4){
+    float vertices[] = {
+        x1, y1, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x1, y1,
+        x2, y2, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x2, y2,
+        x3, y3, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x3, y3,
+        x4, y4, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x4, y4,
+    };
+    
+    unsigned int indices[] = {
+        0, 1, 2,
+        0, 2, 3,
+    };
+
+    return glib_create_obj_copy(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+}
+glib_obj_t* glib_create_quad_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, int rgba_hex){
+    float vertices[] = {
+        x1, y1, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x1, y1,
+        x2, y2, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x2, y2,
+        x3, y3, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x3, y3,
+        x4, y4, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x4, y4,
+    };
+    
+    unsigned int indices[] = {
+        0, 1, 2,
+        0, 2, 3,
+    };
+
+    return glib_create_obj_copy(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+}
+
+// Empty slot of the open addressing hash tables of the loaders
+#define GLIB_HASH_EMPTY 0xFFFFFFFFu
+
+typedef struct {
+    unsigned int p, t;
+    unsigned int vertex; // index of the deduplicated vertex, GLIB_HASH_EMPTY marks an empty slot
+} glib_obj_index_slot_t;
+
+static unsigned int glib_hash_index(unsigned int p, unsigned int t, unsigned int n){
+    unsigned int hash = p*0x9E3779B1u;
+    hash ^= t*0x85EBCA77u + (hash<<6) + (hash>>2);
+    hash ^= n*0xC2B2AE3Du + (hash<<6) + (hash>>2);
+    hash ^= hash>>16;
+    return hash;
+}
+
+// fast_obj reads the OBJ and its MTL files through these callbacks, so the packed files are copied from the mapping
+typedef struct {
+    const char* data;   // NULL if the file is not packed
+    size_t size;
+    size_t pos;
+    FILE* fp;
+} glib_obj_stream_t;
+
+static void* glib_obj_file_open(const char* path, void* user_data){
+    (void)user_data;
+    glib_obj_stream_t* stream = (glib_obj_stream_t*)calloc(1, sizeof(glib_obj_stream_t));
+    if(!stream) fputs("memory alloc fails",stderr),exit(1);
+    stream->data = (const char*)glib_find_packed(path, &stream->size);
+    if(stream->data==NULL){
+        stream->fp = fopen(path, "rb");
+        if(!stream->fp){
+            free(stream);
+            return NULL;
+        }
+    }
+    return stream;
+}
+
+static void glib_obj_file_close(void* file, void* user_data){
+    (void)user_data;
+    glib_obj_stream_t* stream = (glib_obj_stream_t*)file;
+    if(stream->fp){
+        fclose(stream->fp);
+    }
+    free(stream);
+}
+
+static size_t glib_obj_file_read(void* file, void* dst, size_t bytes, void* user_data){
+    (void)user_data;
+    glib_obj_stream_t* stream = (glib_obj_stream_t*)file;
+    if(stream->fp){
+        return fread(dst, 1, bytes, stream->fp);
+    }
+    if(bytes>stream->size-stream->pos){
+        bytes = stream->size-stream->pos;
+    }
+    memcpy(dst, stream->data+stream->pos, bytes);
+    stream->pos += bytes;
+    return bytes;
+}
+
+static unsigned long glib_obj_file_size(void* file, void* user_data){
+    (void)user_data;
+    glib_obj_stream_t* stream = (glib_obj_stream_t*)file;
+    if(stream->fp){
+        long pos = ftell(stream->fp);
+        fseek(stream->fp, 0L, SEEK_END);
+        long size = ftell(stream->fp);
+        fseek(stream->fp, pos, SEEK_SET);
+        return (unsigned long)size;
+    }
+    return (unsigned long)stream->size;
+}
+
+static void glib_parse_obj(const char* file_path, float** out_vertices, unsigned int* out_vertex_len, unsigned int** out_indices, unsigned int* out_index_len){
+    fastObjCallbacks callbacks = {glib_obj_file_open, glib_obj_file_close, glib_obj_file_read, glib_obj_file_size};
+    fastObjMesh* mesh = fast_obj_read_with_callbacks(file_path, &callbacks, NULL);
+    if(!mesh){
+        fprintf(stderr, "Failed to load model. %s\n", file_path);
+        exit(-1);
+    }
+
+    unsigned int index_len = 0;
+    for(unsigned int f = 0; f<mesh->face_count; f++){
+        if(mesh->face_vertices[f]>=3){
+            index_len += (mesh->face_vertices[f]-2)*3;
+        }
+    }
+
+    // open addressing, kept at most half full
+    unsigned int slot_cap = 16;
+    while(slot_cap<mesh->index_count*2) slot_cap *= 2;
+    glib_obj_index_slot_t* slots = (glib_obj_index_slot_t*)malloc(sizeof(glib_obj_index_slot_t)*slot_cap);
+    unsigned int* indices = (unsigned int*)malloc(sizeof(unsigned int)*(index_len?index_len:1));
+    // vertex index of every corner of the current face, before triangulation
+    unsigned int* corner = NULL;
+    unsigned int corner_cap = 0;
+    unsigned int vertex_cap = 1024;
+    unsigned int vertex_count = 0;
+    float* vertices = (float*)malloc(sizeof(float)*GLIB_VERTEX_FLOAT_COUNT*vertex_cap);
+    if(!slots || !indices || !vertices) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<slot_cap; i++){
+        slots[i].vertex = GLIB_HASH_EMPTY;
+    }
+
+    unsigned int index_pos = 0;
+    unsigned int written = 0;
+    for(unsigned int f = 0; f<mesh->face_count; f++){
+        unsigned int face_len = mesh->face_vertices[f];
+        if(face_len>corner_cap){
+            corner_cap = face_len*2;
+            corner = (unsigned int*)realloc(corner, sizeof(unsigned int)*corner_cap);
+            if(!corner) fputs("memory alloc fails",stderr),exit(1);
+        }
+
+        for(unsigned int c = 0; c<face_len; c++){
+            fastObjIndex idx = mesh->indices[index_pos+c];
+            // the layout has no normal, so the corners which differ only in it share a vertex
+            unsigned int slot = glib_hash_index(idx.p, idx.t, 0)&(slot_cap-1);
+            while(slots[slot].vertex!=GLIB_HASH_EMPTY &&
+                  (slots[slot].p!=idx.p || slots[slot].t!=idx.t)){
+                slot = (slot+1)&(slot_cap-1);
+            }
+
+            if(slots[slot].vertex==GLIB_HASH_EMPTY){
+                if(vertex_count==vertex_cap){
+                    vertex_cap *= 2;
+                    vertices = (float*)realloc(vertices, sizeof(float)*GLIB_VERTEX_FLOAT_COUNT*vertex_cap);
+                    if(!vertices) fputs("memory alloc fails",stderr),exit(1);
+                }
+                // index 0 is the "missing" entry in fast_obj, it holds zeros
+                float* v = vertices+vertex_count*GLIB_VERTEX_FLOAT_COUNT;
+                v[0] = mesh->positions[idx.p*3+0];
+                v[1] = mesh->positions[idx.p*3+1];
+                v[2] = mesh->positions[idx.p*3+2];
+                v[3] = 1.0f;
+                v[4] = 1.0f;
+                v[5] = 1.0f;
+                v[6] = 1.0f;
+                v[7] = mesh->texcoords[idx.t*2+0];
+                v[8] = mesh->texcoords[idx.t*2+1];
+
+                slots[slot].p = idx.p;
+                slots[slot].t = idx.t;
+                slots[slot].vertex = vertex_count++;
+            }
+            corner[c] = slots[slot].vertex;
+        }
+
+        // triangle fan
+        for(unsigned int c = 2; c<face_len; c++){
+            indices[written++] = corner[0];
+            indices[written++] = corner[c-1];
+            indices[written++] = corner[c];
+        }
+        index_pos += face_len;
+    }
+
+    free(corner);
+    free(slots);
+    fast_obj_destroy(mesh);
+
+    *out_vertices = (float*)realloc(vertices, sizeof(float)*GLIB_VERTEX_FLOAT_COUNT*(vertex_count?vertex_count:1));
+    *out_vertex_len = vertex_count*GLIB_VERTEX_FLOAT_COUNT;
+    *out_indices = indices;
+    *out_index_len = index_len;
+}
+
+// 64 bytes, the vertex and index blocks follow it 16 byte aligned
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int vertex_float_count;
+    unsigned int source_hash;        // hash of the source file path
+    unsigned long long source_size;  // size of the source file, 0 if the mesh has no source
+    long long source_mtime;          // modification time of the source file
+    unsigned int vertex_len;
+    unsigned int index_len;
+    unsigned long long vertex_offset;
+    unsigned long long index_offset;
+    unsigned char reserved[8];
+} glib_mesh_header_t;
+
+#define GLIB_MESH_ALIGN(N) (((N)+15ull)&~15ull)
+
+static bool glib_write_mesh(const char* file_path, glib_obj_t* obj, const glib_mesh_header_t* source){
+    // the mesh format stores the default layout with 32 bit indices
+    if(!glib_is_default_vertex_layout(&obj->layout) || obj->index_type!=GLIB_INDEX_UINT32){
+        return false;
+    }
+    glib_mesh_header_t header;
+    memset(&header, 0, sizeof(header));
+    if(source){
+        header = *source;
+    }
+    header.magic = GLIB_MESH_MAGIC;
+    header.version = GLIB_MESH_VERSION;
+    header.vertex_float_count = GLIB_VERTEX_FLOAT_COUNT;
+    header.vertex_len = obj->vertex_len;
+    header.index_len = obj->index_len;
+    header.vertex_offset = GLIB_MESH_ALIGN(sizeof(glib_mesh_header_t));
+    header.index_offset = GLIB_MESH_ALIGN(header.vertex_offset+sizeof(float)*obj->vertex_len);
+
+    FILE* fp = fopen(file_path, "wb");
+    if(!fp){
+        return false;
+    }
+    static const char padding[16] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, fp)==1;
+    ok = ok && fwrite(padding, 1, header.vertex_offset-sizeof(header), fp)==header.vertex_offset-sizeof(header);
+    ok = ok && (obj->vertex_len==0 || fwrite(obj->vertices, sizeof(float), obj->vertex_len, fp)==obj->vertex_len);
+    size_t vertex_end = header.vertex_offset+sizeof(float)*obj->vertex_len;
+    ok = ok && fwrite(padding, 1, header.index_offset-vertex_end, fp)==header.index_offset-vertex_end;
+    ok = ok && (obj->index_len==0 || fwrite(obj->indices, sizeof(unsigned int), obj->index_len, fp)==obj->index_len);
+    ok = (fclose(fp)==0) && ok;
+    if(!ok){
+        remove(file_path);
+    }
+    return ok;
+}
+
+// create an object from a mesh file in memory, if source is given the file has to be made from the same source, otherwise NULL is returned
+static glib_obj_t* glib_mesh_from_memory(const void* data, size_t size, const glib_mesh_header_t* source){
+    const glib_mesh_header_t* header = (const glib_mesh_header_t*)data;
+    bool valid = size>=sizeof(glib_mesh_header_t) &&
+        header->magic==GLIB_MESH_MAGIC &&
+        header->version==GLIB_MESH_VERSION &&
+        header->vertex_float_count==GLIB_VERTEX_FLOAT_COUNT &&
+        header->vertex_offset<=size && sizeof(float)*(unsigned long long)header->vertex_len<=size-header->vertex_offset &&
+        header->index_offset<=size && sizeof(unsigned int)*(unsigned long long)header->index_len<=size-header->index_offset;
+    if(valid && source){
+        valid = header->source_hash==source->source_hash &&
+            header->source_size==source->source_size &&
+            header->source_mtime==source->source_mtime;
+    }
+    if(!valid){
+        return NULL;
+    }
+
+    // glBufferData reads straight from the mapped pages
+    const char* base = (const char*)data;
+    glib_obj_t* obj = glib_create_obj((float*)(base+header->vertex_offset), header->vertex_len, (unsigned int*)(base+header->index_offset), header->index_len);
+    obj->vertices = NULL;
+    obj->indices = NULL;
+    return obj;
+}
+
+static glib_obj_t* glib_read_mesh(const char* file_path, const glib_mesh_header_t* source){
+    glib_mapped_file_t file;
+    if(!glib_map_file(file_path, &file)){
+        return NULL;
+    }
+    glib_obj_t* obj = glib_mesh_from_memory(file.data, file.size, source);
+    glib_unmap_file(&file);
+    return obj;
+}
+
+bool glib_save_mesh(const char* file_path, glib_obj_t* obj){
+    return glib_write_mesh(file_path, obj, NULL);
+}
+
+glib_obj_t* glib_load_mesh(const char* file_path){
+    size_t packed_size;
+    const void* packed = glib_find_packed(file_path, &packed_size);
+    if(packed){
+        return glib_mesh_from_memory(packed, packed_size, NULL);
+    }
+    return glib_read_mesh(file_path, NULL);
+}
+
+glib_obj_t* glib_load_obj(const char* file_path){
+    size_t packed_size = 0;
+    const void* packed = glib_find_packed(file_path, &packed_size);
+    struct stat st;
+    bool on_disk = stat(file_path, &st)==0;
+    if(!packed && !on_disk){
+        fprintf(stderr, "Failed to load model. %s\n", file_path);
+        exit(-1);
+    }
+
+    // the packed data has no time, the file on disk gives it if there is one, so the cache on disk fits both
+    glib_mesh_header_t source;
+    memset(&source, 0, sizeof(source));
+    source.source_hash = glib_hash_str(file_path);
+    source.source_size = packed?packed_size:(unsigned long long)st.st_size;
+    source.source_mtime = on_disk?st.st_mtime:0;
+
+    char* cache_path = glib_make_cache_path(file_path, GLIB_MESH_CACHE_EXT);
+
+    glib_obj_t* obj = NULL;
+    if(packed){
+        // a pack is built at once, so its cache is used without the source checks
+        size_t cache_size;
+        const void* cache = glib_find_packed(cache_path, &cache_size);
+        obj = cache?glib_mesh_from_memory(cache, cache_size, NULL):NULL;
+    }
+    if(obj==NULL){
+        obj = glib_read_mesh(cache_path, &source);
+    }
+    if(obj==NULL){
+        float* vertices;
+        unsigned int* indices;
+        unsigned int vertex_len, index_len;
+        glib_parse_obj(file_path, &vertices, &vertex_len, &indices, &index_len);
+
+        obj = glib_create_obj(vertices, vertex_len, indices, index_len);
+        obj->owns_vertices = true;
+        obj->owns_indices = true;
+        if(!glib_write_mesh(cache_path, obj, &source)){
+            fprintf(stderr, "[WARN] Cannot write mesh cache. %s\n", cache_path);
+        }
+    }
+    free(cache_path);
+    return obj;
+}
+
+// Phase one of glib_load_obj_parallel parses the v and vt records of every part, the normals are not in the default vertex layout.
+// Phase two knows the records before each part, so it resolves the face indices to global ones while it parses the faces again,
+// and hands the full batches to the loading thread
+typedef struct glib_obj_loader_t glib_obj_loader_t;
+
+typedef struct {
+    glib_obj_loader_t* loader;
+    const char* begin;
+    const char* end;
+    float* positions;       // 3 floats per v record of the part
+    float* texcoords;       // 2 floats per vt record of the part
+    unsigned int position_count, position_cap;
+    unsigned int texcoord_count, texcoord_cap;
+    // the records of the parts before this one
+    unsigned int position_base, texcoord_base;
+    bool invalid_face;
+} glib_obj_part_t;
+
+typedef struct {
+    float* vertices;
+    unsigned int* keys;     // the (position, texcoord) index pair of every vertex
+    unsigned int* indices;
+    unsigned int vertex_count;
+    unsigned int index_count;
+} glib_obj_batch_t;
+
+#define GLIB_OBJ_BATCH_INDICES (GLIB_OBJ_BATCH_VERTICES*6)
+#define GLIB_OBJ_QUEUE_SIZE (GLIB_OBJ_THREADS*2)
+#define GLIB_OBJ_NO_TEXCOORD 0xFFFFFFFFu
+
+struct glib_obj_loader_t {
+    glib_obj_part_t parts[GLIB_OBJ_THREADS];
+    unsigned int part_count;
+    unsigned int position_count;
+    unsigned int texcoord_count;
+    // the full batches wait here for the upload, the workers wait while it is full
+    glib_obj_batch_t* queue[GLIB_OBJ_QUEUE_SIZE];
+    unsigned int queue_head;
+    unsigned int queue_count;
+    unsigned int finished;
+    pthread_mutex_t mutex;
+    pthread_cond_t pushed;
+    pthread_cond_t popped;
+    // (position, texcoord) -> vertex of the whole model, only the loading thread uses it
+    glib_obj_index_slot_t* vertex_slots;
+    unsigned int vertex_slot_cap;
+    unsigned int* remap;    // batch vertex -> vertex of the model
+};
+
+static const char* glib_obj_skip_spaces(const char* p, const char* end){
+    while(p<end && (*p==' ' || *p=='\t')) p++;
+    return p;
+}
+
+static const char* glib_obj_next_line(const char* p, const char* end){
+    const char* newline = (const char*)memchr(p, '\n', end-p);
+    return newline?newline+1:end;
+}
+
+// a decimal float like "-1.25e-3" without strtod and its locale, the digits after the 18th are dropped
+static const char* glib_obj_parse_float(const char* p, const char* end, float* out){
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    p = glib_obj_skip_spaces(p, end);
+    bool negative = false;
+    if(p<end && (*p=='-' || *p=='+')){
+        negative = *p=='-';
+        p++;
+    }
+    unsigned long long mantissa = 0;
+    int exponent = 0;
+    for(; p<end && *p>='0' && *p<='9'; p++){
+        if(mantissa<100000000000000000ull){
+            mantissa = mantissa*10+(*p-'0');
+        }else{
+            exponent++;
+        }
+    }
+    if(p<end && *p=='.'){
+        for(p++; p<end && *p>='0' && *p<='9'; p++){
+            if(mantissa<100000000000000000ull){
+                mantissa = mantissa*10+(*p-'0');
+                exponent--;
+            }
+        }
+    }
+    if(p<end && (*p=='e' || *p=='E')){
+        p++;
+        bool negative_exponent = false;
+        if(p<end && (*p=='-' || *p=='+')){
+            negative_exponent = *p=='-';
+            p++;
+        }
+        int e = 0;
+        for(; p<end && *p>='0' && *p<='9'; p++){
+            if(e<1000){
+                e = e*10+(*p-'0');
+            }
+        }
+        exponent += negative_exponent?-e:e;
+    }
+
+    // the powers are exact up to 1e22
+    double value = (double)mantissa;
+    while(exponent>22){
+        value *= 1e22;
+        exponent -= 22;
+    }
+    while(exponent<-22){
+        value /= 1e22;
+        exponent += 22;
+    }
+    value = exponent<0?value/powers[-exponent]:value*powers[exponent];
+    *out = (float)(negative?-value:value);
+    return p;
+}
+
+static const char* glib_obj_parse_int(const char* p, const char* end, long long* out){
+    bool negative = false;
+    if(p<end && (*p=='-' || *p=='+')){
+        negative = *p=='-';
+        p++;
+    }
+    long long value = 0;
+    for(; p<end && *p>='0' && *p<='9'; p++){
+        if(value<(1ll<<40)){
+            value = value*10+(*p-'0');
+        }
+    }
+    *out = negative?-value:value;
+    return p;
+}
+
+typedef enum {
+    GLIB_OBJ_RECORD_OTHER = 0,
+    GLIB_OBJ_RECORD_POSITION,
+    GLIB_OBJ_RECORD_TEXCOORD,
+    GLIB_OBJ_RECORD_FACE,
+} glib_obj_record;
+
+// the kind of the record at p, p is moved after its keyword
+static glib_obj_record glib_obj_record_kind(const char** p, const char* end){
+    const char* q = glib_obj_skip_spaces(*p, end);
+    glib_obj_record kind = GLIB_OBJ_RECORD_OTHER;
+    int keyword = 0;
+    if(end-q>=2 && q[0]=='v' && (q[1]==' ' || q[1]=='\t')){
+        kind = GLIB_OBJ_RECORD_POSITION;
+        keyword = 1;
+    }else if(end-q>=3 && q[0]=='v' && q[1]=='t' && (q[2]==' ' || q[2]=='\t')){
+        kind = GLIB_OBJ_RECORD_TEXCOORD;
+        keyword = 2;
+    }else if(end-q>=2 && q[0]=='f' && (q[1]==' ' || q[1]=='\t')){
+        kind = GLIB_OBJ_RECORD_FACE;
+        keyword = 1;
+    }
+    *p = q+keyword;
+    return kind;
+}
+
+static void* glib_obj_scan_part(void* arg){
+    glib_obj_part_t* part = (glib_obj_part_t*)arg;
+    const char* p = part->begin;
+    while(p<part->end){
+        const char* line_end = glib_obj_next_line(p, part->end);
+        glib_obj_record kind = glib_obj_record_kind(&p, line_end);
+        if(kind==GLIB_OBJ_RECORD_POSITION){
+            if(part->position_count==part->position_cap){
+                part->position_cap = part->position_cap?part->position_cap*2:4096;
+                part->positions = (float*)realloc(part->positions, sizeof(float)*3*part->position_cap);
+                if(!part->positions) fputs("memory alloc fails",stderr),exit(1);
+            }
+            float* v = part->positions+part->position_count++*3;
+            p = glib_obj_parse_float(p, line_end, &v[0]);
+            p = glib_obj_parse_float(p, line_end, &v[1]);
+            glib_obj_parse_float(p, line_end, &v[2]);
+        }else if(kind==GLIB_OBJ_RECORD_TEXCOORD){
+            if(part->texcoord_count==part->texcoord_cap){
+                part->texcoord_cap = part->texcoord_cap?part->texcoord_cap*2:4096;
+                part->texcoords = (float*)realloc(part->texcoords, sizeof(float)*2*part->texcoord_cap);
+                if(!part->texcoords) fputs("memory alloc fails",stderr),exit(1);
+            }
+            float* vt = part->texcoords+part->texcoord_count++*2;
+            p = glib_obj_parse_float(p, line_end, &vt[0]);
+            glib_obj_parse_float(p, line_end, &vt[1]);
+        }
+        p = line_end;
+    }
+    return NULL;
+}
+
+static const float* glib_obj_loader_position(glib_obj_loader_t* loader, unsigned int index){
+    unsigned int i = loader->part_count-1;
+    while(loader->parts[i].position_base>index) i--;
+    return loader->parts[i].positions+(size_t)(index-loader->parts[i].position_base)*3;
+}
+
+static const float* glib_obj_loader_texcoord(glib_obj_loader_t* loader, unsigned int index){
+    unsigned int i = loader->part_count-1;
+    while(loader->parts[i].texcoord_base>index) i--;
+    return loader->parts[i].texcoords+(size_t)(index-loader->parts[i].texcoord_base)*2;
+}
+
+static glib_obj_batch_t* glib_obj_new_batch(void){
+    glib_obj_batch_t* batch = (glib_obj_batch_t*)malloc(sizeof(glib_obj_batch_t));
+    if(!batch) fputs("memory alloc fails",stderr),exit(1);
+    batch->vertices = (float*)malloc(sizeof(float)*GLIB_VERTEX_FLOAT_COUNT*GLIB_OBJ_BATCH_VERTICES);
+    batch->keys = (unsigned int*)malloc(sizeof(unsigned int)*2*GLIB_OBJ_BATCH_VERTICES);
+    batch->indices = (unsigned int*)malloc(sizeof(unsigned int)*GLIB_OBJ_BATCH_INDICES);
+    if(!batch->vertices || !batch->keys || !batch->indices) fputs("memory alloc fails",stderr),exit(1);
+    batch->vertex_count = 0;
+    batch->index_count = 0;
+    return batch;
+}
+
+static void glib_obj_free_batch(glib_obj_batch_t* batch){
+    free(batch->vertices);
+    free(batch->keys);
+    free(batch->indices);
+    free(batch);
+}
+
+static void glib_obj_push_batch(glib_obj_loader_t* loader, glib_obj_batch_t* batch){
+    pthread_mutex_lock(&loader->mutex);
+    while(loader->queue_count==GLIB_OBJ_QUEUE_SIZE){
+        pthread_cond_wait(&loader->popped, &loader->mutex);
+    }
+    loader->queue[(loader->queue_head+loader->queue_count)%GLIB_OBJ_QUEUE_SIZE] = batch;
+    loader->queue_count++;
+    pthread_cond_signal(&loader->pushed);
+    pthread_mutex_unlock(&loader->mutex);
+}
+
+// marks an OBJ index that is zero or out of range
+#define GLIB_OBJ_NO_INDEX 0xFFFFFFFFu
+
+// resolve an OBJ index, the negative ones count back from the records before the line
+static unsigned int glib_obj_resolve_index(long long index, unsigned int records_before, unsigned int record_count){
+    long long resolved = index>0?index-1:(long long)records_before+index;
+    if(index==0 || resolved<0 || resolved>=record_count){
+        return GLIB_OBJ_NO_INDEX;
+    }
+    return (unsigned int)resolved;
+}
+
+static void* glib_obj_build_part(void* arg){
+    glib_obj_part_t* part = (glib_obj_part_t*)arg;
+    glib_obj_loader_t* loader = part->loader;
+    unsigned int positions = part->position_base;
+    unsigned int texcoords = part->texcoord_base;
+
+    // (position, texcoord) -> vertex of the current batch, kept at most half full
+    unsigned int slot_cap = 16;
+    while(slot_cap<GLIB_OBJ_BATCH_VERTICES*2) slot_cap *= 2;
+    glib_obj_index_slot_t* slots = (glib_obj_index_slot_t*)malloc(sizeof(glib_obj_index_slot_t)*slot_cap);
+    unsigned int* corner = (unsigned int*)malloc(sizeof(unsigned int)*GLIB_OBJ_BATCH_VERTICES);
+    if(!slots || !corner) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<slot_cap; i++){
+        slots[i].vertex = GLIB_HASH_EMPTY;
+    }
+    glib_obj_batch_t* batch = glib_obj_new_batch();
+
+    const char* p = part->begin;
+    while(p<part->end){
+        const char* line_end = glib_obj_next_line(p, part->end);
+        glib_obj_record kind = glib_obj_record_kind(&p, line_end);
+        if(kind==GLIB_OBJ_RECORD_POSITION){
+            positions++;
+        }else if(kind==GLIB_OBJ_RECORD_TEXCOORD){
+            texcoords++;
+        }else if(kind==GLIB_OBJ_RECORD_FACE){
+            // the corners are resolved first, a face with a bad index is dropped
+            unsigned int corner_count = 0;
+            const char* face = p;
+            bool valid = true;
+            for(int pass = 0; pass<2 && valid; pass++){
+                // the first pass counts and checks the corners, the second one adds them to the batch
+                p = face;
+                unsigned int c = 0;
+                while(true){
+                    p = glib_obj_skip_spaces(p, line_end);
+                    if(p>=line_end || *p=='\r' || *p=='\n' || *p=='#'){
+                        break;
+                    }
+                    long long vi = 0, ti = 0;
+                    p = glib_obj_parse_int(p, line_end, &vi);
+                    if(p<line_end && *p=='/'){
+                        p++;
+                        if(p<line_end && *p!='/'){
+                            p = glib_obj_parse_int(p, line_end, &ti);
+                        }
+                    }
+                    while(p<line_end && *p!=' ' && *p!='\t' && *p!='\r' && *p!='\n') p++;
+
+                    unsigned int vp = glib_obj_resolve_index(vi, positions, loader->position_count);
+                    unsigned int vt = ti==0?GLIB_OBJ_NO_TEXCOORD:glib_obj_resolve_index(ti, texcoords, loader->texcoord_count);
+                    if(vp==GLIB_OBJ_NO_INDEX || (ti!=0 && vt==GLIB_OBJ_NO_INDEX) || c==GLIB_OBJ_BATCH_VERTICES){
+                        valid = false;
+                        break;
+                    }
+                    if(pass==1){
+                        unsigned int slot = glib_hash_index(vp, vt, 0)&(slot_cap-1);
+                        while(slots[slot].vertex!=GLIB_HASH_EMPTY && (slots[slot].p!=vp || slots[slot].t!=vt)){
+                            slot = (slot+1)&(slot_cap-1);
+                        }
+                        if(slots[slot].vertex==GLIB_HASH_EMPTY){
+                            const float* position = glib_obj_loader_position(loader, vp);
+                            float* v = batch->vertices+batch->vertex_count*GLIB_VERTEX_FLOAT_COUNT;
+                            v[0] = position[0];
+                            v[1] = position[1];
+                            v[2] = position[2];
+                            v[3] = 1.0f;
+                            v[4] = 1.0f;
+                            v[5] = 1.0f;
+                            v[6] = 1.0f;
+                            if(vt==GLIB_OBJ_NO_TEXCOORD){
+                                v[7] = 0.0f;
+                                v[8] = 0.0f;
+                            }else{
+                                const float* texcoord = glib_obj_loader_texcoord(loader, vt);
+                                v[7] = texcoord[0];
+                                v[8] = texcoord[1];
+                            }
+                            slots[slot].p = vp;
+                            slots[slot].t = vt;
+                            batch->keys[batch->vertex_count*2] = vp;
+                            batch->keys[batch->vertex_count*2+1] = vt;
+                            slots[slot].vertex = batch->vertex_count++;
+                        }
+                        corner[c] = slots[slot].vertex;
+                    }
+                    c++;
+                }
+                corner_count = c;
+                if(pass==0 && valid && corner_count>=3 &&
+                   (batch->vertex_count+corner_count>GLIB_OBJ_BATCH_VERTICES || batch->index_count+(corner_count-2)*3>GLIB_OBJ_BATCH_INDICES)){
+                    glib_obj_push_batch(loader, batch);
+                    batch = glib_obj_new_batch();
+                    for(unsigned int i = 0; i<slot_cap; i++){
+                        slots[i].vertex = GLIB_HASH_EMPTY;
+                    }
+                }
+                if(corner_count<3){
+                    break;
+                }
+            }
+            if(!valid){
+                part->invalid_face = true;
+            }else if(corner_count>=3){
+                // triangle fan
+                for(unsigned int c = 2; c<corner_count; c++){
+                    batch->indices[batch->index_count++] = corner[0];
+                    batch->indices[batch->index_count++] = corner[c-1];
+                    batch->indices[batch->index_count++] = corner[c];
+                }
+            }
+        }
+        p = line_end;
+    }
+
+    if(batch->index_count>0){
+        glib_obj_push_batch(loader, batch);
+    }else{
+        glib_obj_free_batch(batch);
+    }
+    free(slots);
+    free(corner);
+
+    pthread_mutex_lock(&loader->mutex);
+    loader->finished++;
+    pthread_cond_signal(&loader->pushed);
+    pthread_mutex_unlock(&loader->mutex);
+    return NULL;
+}
+
+// copy the used part of a buffer into a bigger one, the old one is deleted when the GPU is done with it
+static unsigned int glib_obj_grow_buffer(unsigned int buffer, size_t used, size_t size){
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STATIC_DRAW);
+    if(used>0){
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glib_defer_delete(GL_BUFFER, buffer);
+    return grown;
+}
+
+static void glib_obj_grow_vertex_slots(glib_obj_loader_t* loader, unsigned int slot_cap){
+    glib_obj_index_slot_t* old_slots = loader->vertex_slots;
+    unsigned int old_cap = loader->vertex_slot_cap;
+    loader->vertex_slots = (glib_obj_index_slot_t*)malloc(sizeof(glib_obj_index_slot_t)*slot_cap);
+    if(!loader->vertex_slots) fputs("memory alloc fails",stderr),exit(1);
+    loader->vertex_slot_cap = slot_cap;
+    for(unsigned int i = 0; i<slot_cap; i++){
+        loader->vertex_slots[i].vertex = GLIB_HASH_EMPTY;
+    }
+    for(unsigned int i = 0; i<old_cap; i++){
+        if(old_slots[i].vertex==GLIB_HASH_EMPTY){
+            continue;
+        }
+        unsigned int slot = glib_hash_index(old_slots[i].p, old_slots[i].t, 0)&(slot_cap-1);
+        while(loader->vertex_slots[slot].vertex!=GLIB_HASH_EMPTY){
+            slot = (slot+1)&(slot_cap-1);
+        }
+        loader->vertex_slots[slot] = old_slots[i];
+    }
+    free(old_slots);
+}
+
+// the vertices of the batch which the earlier batches already have are dropped, the kept ones are moved to the front
+// and the indices are made global, so the parts and batches share the vertices on their borders
+static void glib_obj_merge_batch(glib_obj_loader_t* loader, glib_obj_batch_t* batch, unsigned int vertex_end){
+    if((unsigned long long)(vertex_end+batch->vertex_count)*2>loader->vertex_slot_cap){
+        unsigned int slot_cap = loader->vertex_slot_cap;
+        while((unsigned long long)(vertex_end+batch->vertex_count)*2>slot_cap) slot_cap *= 2;
+        glib_obj_grow_vertex_slots(loader, slot_cap);
+    }
+    unsigned int* remap = loader->remap;
+    unsigned int kept = 0;
+    unsigned int mask = loader->vertex_slot_cap-1;
+    for(unsigned int v = 0; v<batch->vertex_count; v++){
+        unsigned int vp = batch->keys[v*2], vt = batch->keys[v*2+1];
+        unsigned int slot = glib_hash_index(vp, vt, 0)&mask;
+        while(loader->vertex_slots[slot].vertex!=GLIB_HASH_EMPTY && (loader->vertex_slots[slot].p!=vp || loader->vertex_slots[slot].t!=vt)){
+            slot = (slot+1)&mask;
+        }
+        if(loader->vertex_slots[slot].vertex==GLIB_HASH_EMPTY){
+            loader->vertex_slots[slot].p = vp;
+            loader->vertex_slots[slot].t = vt;
+            loader->vertex_slots[slot].vertex = vertex_end+kept;
+            if(kept!=v){
+                memcpy(batch->vertices+(size_t)kept*GLIB_VERTEX_FLOAT_COUNT, batch->vertices+(size_t)v*GLIB_VERTEX_FLOAT_COUNT, sizeof(float)*GLIB_VERTEX_FLOAT_COUNT);
+            }
+            kept++;
+        }
+        remap[v] = loader->vertex_slots[slot].vertex;
+    }
+    for(unsigned int i = 0; i<batch->index_count; i++){
+        batch->indices[i] = remap[batch->indices[i]];
+    }
+    batch->vertex_count = kept;
+}
+
+static void glib_obj_upload_batch(glib_obj_loader_t* loader, glib_obj_t* obj, glib_obj_batch_t* batch, unsigned int* vertex_end, unsigned int* index_end){
+    glib_obj_merge_batch(loader, batch, *vertex_end);
+    size_t stride = obj->layout.stride;
+    if(*vertex_end+batch->vertex_count>obj->vertex_capacity){
+        unsigned int capacity = obj->vertex_capacity;
+        while(capacity<*vertex_end+batch->vertex_count) capacity += capacity/2+1;
+        obj->VBO = glib_obj_grow_buffer(obj->VBO, (size_t)*vertex_end*stride, (size_t)capacity*stride);
+        obj->vertex_capacity = capacity;
+
+        glib_bind_vao(obj->VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+        for(unsigned int i = 0; i<obj->layout.attrib_count; i++){
+            const glib_vertex_attrib_t* attrib = &obj->layout.attribs[i];
+            glVertexAttribPointer(attrib->location, attrib->size, glib_gl_attrib_type(attrib->type), attrib->normalized?GL_TRUE:GL_FALSE, stride, (void*)(size_t)attrib->offset);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if(*index_end+batch->index_count>obj->index_capacity){
+        unsigned int capacity = obj->index_capacity;
+        while(capacity<*index_end+batch->index_count) capacity += capacity/2+1;
+        obj->EBO = glib_obj_grow_buffer(obj->EBO, sizeof(unsigned int)*(size_t)*index_end, sizeof(unsigned int)*(size_t)capacity);
+        obj->index_capacity = capacity;
+        glib_bind_vao(obj->VAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj->EBO);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, (size_t)*vertex_end*stride, (size_t)batch->vertex_count*stride, batch->vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glib_bind_vao(obj->VAO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*(size_t)*index_end, sizeof(unsigned int)*(size_t)batch->index_count, batch->indices);
+    glib_obj_extend_bounds(obj, batch->vertices, (size_t)*vertex_end*stride, (size_t)batch->vertex_count*stride);
+
+    *vertex_end += batch->vertex_count;
+    *index_end += batch->index_count;
+}
+
+static void glib_obj_run_parts(glib_obj_loader_t* loader, void* (*fun)(void*), pthread_t* threads){
+    for(unsigned int i = 0; i<loader->part_count; i++){
+        if(pthread_create(&threads[i], NULL, fun, &loader->parts[i])!=0){
+            fprintf(stderr, "ERROR: cannot start OBJ parser thread\n");
+            exit(-1);
+        }
+    }
+}
+
+glib_obj_t* glib_load_obj_parallel(const char* file_path){
+    glib_profile_scope_t scope = glib_profile_begin("glib_load_obj_parallel", false);
+    glib_mapped_file_t file;
+    memset(&file, 0, sizeof(file));
+    size_t size = 0;
+    const char* data = (const char*)glib_find_packed(file_path, &size);
+    if(data==NULL){
+        if(!glib_map_file(file_path, &file)){
+            fprintf(stderr, "Failed to load model. %s\n", file_path);
+            exit(-1);
+        }
+        data = (const char*)file.data;
+        size = file.size;
+    }
+
+    glib_obj_loader_t* loader = (glib_obj_loader_t*)calloc(1, sizeof(glib_obj_loader_t));
+    if(!loader) fputs("memory alloc fails",stderr),exit(1);
+
+    // the parts end at line ends, a small file is not split
+    size_t part_count = size/(1<<20)+1;
+    loader->part_count = part_count<GLIB_OBJ_THREADS?(unsigned int)part_count:GLIB_OBJ_THREADS;
+    const char* begin = data;
+    for(unsigned int i = 0; i<loader->part_count; i++){
+        const char* end = i+1==loader->part_count?data+size:glib_obj_next_line(data+size/loader->part_count*(i+1), data+size);
+        if(end<begin){
+            end = begin;
+        }
+        loader->parts[i].loader = loader;
+        loader->parts[i].begin = begin;
+        loader->parts[i].end = end;
+        begin = end;
+    }
+
+    pthread_t threads[GLIB_OBJ_THREADS];
+    glib_obj_run_parts(loader, glib_obj_scan_part, threads);
+    for(unsigned int i = 0; i<loader->part_count; i++){
+        pthread_join(threads[i], NULL);
+    }
+    for(unsigned int i = 0; i<loader->part_count; i++){
+        glib_obj_part_t* part = &loader->parts[i];
+        part->position_base = loader->position_count;
+        part->texcoord_base = loader->texcoord_count;
+        loader->position_count += part->position_count;
+        loader->texcoord_count += part->texcoord_count;
+    }
+
+    // a closed triangle mesh has about twice as many triangles as vertices, the buffers grow if the guess is low
+    glib_vertex_layout_t layout = glib_default_vertex_layout();
+    unsigned int vertex_capacity = loader->position_count>loader->texcoord_count?loader->position_count:loader->texcoord_count;
+    vertex_capacity = vertex_capacity>0?vertex_capacity:1;
+    unsigned int index_capacity = vertex_capacity<0x7FFFFFFFu/6?vertex_capacity*6:0x7FFFFFFFu;
+    glib_obj_t* obj = glib_create_obj_buffers(NULL, vertex_capacity, &layout, NULL, 0, GLIB_INDEX_UINT32, GLIB_BUFFER_STATIC);
+    unsigned int EBO;
+    glGenBuffers(1, &EBO);
+    obj->EBO = EBO;
+    glib_bind_vao(obj->VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj->EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*(size_t)index_capacity, NULL, GL_STATIC_DRAW);
+    obj->index_capacity = index_capacity;
+    glm_vec3_copy((vec3){GLIB_UNBOUNDED, GLIB_UNBOUNDED, GLIB_UNBOUNDED}, obj->bounds_min);
+    glm_vec3_copy((vec3){-GLIB_UNBOUNDED, -GLIB_UNBOUNDED, -GLIB_UNBOUNDED}, obj->bounds_max);
+
+    unsigned int slot_cap = 16;
+    while(slot_cap<vertex_capacity*2 && slot_cap<0x80000000u) slot_cap *= 2;
+    glib_obj_grow_vertex_slots(loader, slot_cap);
+    loader->remap = (unsigned int*)malloc(sizeof(unsigned int)*GLIB_OBJ_BATCH_VERTICES);
+    if(!loader->remap) fputs("memory alloc fails",stderr),exit(1);
+
+    pthread_mutex_init(&loader->mutex, NULL);
+    pthread_cond_init(&loader->pushed, NULL);
+    pthread_cond_init(&loader->popped, NULL);
+    glib_obj_run_parts(loader, glib_obj_build_part, threads);
+
+    // only this thread talks to OpenGL
+    unsigned int vertex_end = 0, index_end = 0;
+    while(true){
+        pthread_mutex_lock(&loader->mutex);
+        while(loader->queue_count==0 && loader->finished<loader->part_count){
+            pthread_cond_wait(&loader->pushed, &loader->mutex);
+        }
+        if(loader->queue_count==0){
+            pthread_mutex_unlock(&loader->mutex);
+            break;
+        }
+        glib_obj_batch_t* batch = loader->queue[loader->queue_head];
+        loader->queue_head = (loader->queue_head+1)%GLIB_OBJ_QUEUE_SIZE;
+        loader->queue_count--;
+        pthread_cond_signal(&loader->popped);
+        pthread_mutex_unlock(&loader->mutex);
+
+        glib_obj_upload_batch(loader, obj, batch, &vertex_end, &index_end);
+        glib_obj_free_batch(batch);
+    }
+
+    bool invalid_face = false;
+    for(unsigned int i = 0; i<loader->part_count; i++){
+        pthread_join(threads[i], NULL);
+        invalid_face = invalid_face || loader->parts[i].invalid_face;
+        free(loader->parts[i].positions);
+        free(loader->parts[i].texcoords);
+    }
+    if(invalid_face){
+        fprintf(stderr, "[WARN] Faces with invalid indices are skipped. %s\n", file_path);
+    }
+    pthread_mutex_destroy(&loader->mutex);
+    pthread_cond_destroy(&loader->pushed);
+    pthread_cond_destroy(&loader->popped);
+    free(loader->vertex_slots);
+    free(loader->remap);
+    free(loader);
+    glib_unmap_file(&file);
+
+    obj->vertices = NULL;
+    obj->indices = NULL;
+    obj->vertex_count = vertex_end;
+    obj->vertex_len = vertex_end*GLIB_VERTEX_FLOAT_COUNT;
+    obj->index_len = index_end;
+    if(obj->bounds_min[0]>obj->bounds_max[0]){
+        glm_vec3_copy((vec3){0.0f, 0.0f, 0.0f}, obj->bounds_min);
+        glm_vec3_copy((vec3){0.0f, 0.0f, 0.0f}, obj->bounds_max);
+    }
+    glib_bind_vao(0);
+    glib_profile_end(scope);
+    return obj;
+}
+
+// the index range of a LOD, the indices of the object if it has no LOD chain
+static void glib_obj_lod_range(const glib_obj_t* obj, unsigned int lod, unsigned int* first_index, unsigned int* index_count){
+    if(lod<obj->lod_count){
+        *first_index = obj->lods[lod].first_index;
+        *index_count = obj->lods[lod].index_count;
+    }else{
+        *first_index = 0;
+        *index_count = obj->index_len;
+    }
+}
+
+static void glib_draw_obj_lod(glib_obj_t* obj, unsigned int lod){
+    glib_profile_scope_t scope = glib_profile_begin("glib_draw_obj", false);
+    glib_bind_vao(obj->VAO);
+    if(obj->index_len==0){
+        glDrawArrays(GL_TRIANGLES, glib_obj_base_vertex(obj), obj->vertex_count);
+    }else{
+        unsigned int first_index, index_count;
+        glib_obj_lod_range(obj, lod, &first_index, &index_count);
+        glDrawElementsBaseVertex(GL_TRIANGLES, index_count, obj->index_type==GLIB_INDEX_UINT16?GL_UNSIGNED_SHORT:GL_UNSIGNED_INT, (void*)((size_t)first_index*glib_index_size(obj->index_type)), glib_obj_base_vertex(obj));
+    }
+    glib_profile_end(scope);
+}
+
+void glib_draw_obj(glib_obj_t* obj){
+    glib_draw_obj_lod(obj, obj->lod);
+}
+
+void glib_set_obj_instances(glib_obj_t* obj, const glib_instance_t* instances, unsigned int count){
+    if(obj->instance_VBO==0){
+        glGenBuffers(1, &obj->instance_VBO);
+
+        glib_bind_vao(obj->VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, obj->instance_VBO);
+        // a mat4 attribute is 4 vec4 columns
+        for(int i = 0; i<4; i++){
+            glVertexAttribPointer(GLIB_INSTANCE_MODEL_LOCATION+i, 4, GL_FLOAT, GL_FALSE, sizeof(glib_instance_t), (void*)(offsetof(glib_instance_t, model)+i*sizeof(vec4)));
+            glEnableVertexAttribArray(GLIB_INSTANCE_MODEL_LOCATION+i);
+            glVertexAttribDivisor(GLIB_INSTANCE_MODEL_LOCATION+i, 1);
+        }
+        glVertexAttribPointer(GLIB_INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(glib_instance_t), (void*)offsetof(glib_instance_t, color));
+        glEnableVertexAttribArray(GLIB_INSTANCE_COLOR_LOCATION);
+        glVertexAttribDivisor(GLIB_INSTANCE_COLOR_LOCATION, 1);
+        glib_bind_vao(0);
+    }else{
+        glBindBuffer(GL_ARRAY_BUFFER, obj->instance_VBO);
+    }
+
+    if(count>obj->instance_capacity){
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glib_instance_t)*count, instances, GL_DYNAMIC_DRAW);
+        obj->instance_capacity = count;
+    }else{
+        // orphan the old storage, so the upload does not wait for the draws which still read it
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glib_instance_t)*obj->instance_capacity, NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glib_instance_t)*count, instances);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    obj->instance_count = count;
+}
+
+static void glib_draw_obj_instanced_lod(glib_obj_t* obj, unsigned int instance_count, unsigned int lod){
+    if(instance_count>obj->instance_count){
+        instance_count = obj->instance_count;
+    }
+    if(instance_count==0){
+        return;
+    }
+    glib_bind_vao(obj->VAO);
+    if(obj->index_len==0){
+        glDrawArraysInstanced(GL_TRIANGLES, glib_obj_base_vertex(obj), obj->vertex_count, instance_count);
+    }else{
+        unsigned int first_index, index_count;
+        glib_obj_lod_range(obj, lod, &first_index, &index_count);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, index_count, obj->index_type==GLIB_INDEX_UINT16?GL_UNSIGNED_SHORT:GL_UNSIGNED_INT, (void*)((size_t)first_index*glib_index_size(obj->index_type)), instance_count, glib_obj_base_vertex(obj));
+    }
+}
+
+void glib_draw_obj_instanced(glib_obj_t* obj, unsigned int instance_count){
+    glib_draw_obj_instanced_lod(obj, instance_count, obj->lod);
+}
+
+// symmetric 4x4 matrix of the squared distances to planes: aa ab ac ad bb bc bd cc cd dd
+typedef struct {
+    double m[10];
+} glib_quadric_t;
+
+static void glib_quadric_add_plane(glib_quadric_t* q, double a, double b, double c, double d){
+    q->m[0] += a*a; q->m[1] += a*b; q->m[2] += a*c; q->m[3] += a*d;
+    q->m[4] += b*b; q->m[5] += b*c; q->m[6] += b*d;
+    q->m[7] += c*c; q->m[8] += c*d;
+    q->m[9] += d*d;
+}
+
+static void glib_quadric_add(glib_quadric_t* q, const glib_quadric_t* other){
+    for(int i = 0; i<10; i++){
+        q->m[i] += other->m[i];
+    }
+}
+
+// the sum of the squared distances of p to the planes of a and b
+static double glib_quadric_error(const glib_quadric_t* a, const glib_quadric_t* b, const float* p){
+    double m[10];
+    for(int i = 0; i<10; i++){
+        m[i] = a->m[i]+b->m[i];
+    }
+    double x = p[0], y = p[1], z = p[2];
+    double error = m[0]*x*x+2*m[1]*x*y+2*m[2]*x*z+2*m[3]*x+
+                   m[4]*y*y+2*m[5]*y*z+2*m[6]*y+
+                   m[7]*z*z+2*m[8]*z+
+                   m[9];
+    return error>0.0?error:0.0;
+}
+
+static void glib_triangle_normal(const float* a, const float* b, const float* c, double* n){
+    double e1[3] = {b[0]-a[0], b[1]-a[1], b[2]-a[2]};
+    double e2[3] = {c[0]-a[0], c[1]-a[1], c[2]-a[2]};
+    n[0] = e1[1]*e2[2]-e1[2]*e2[1];
+    n[1] = e1[2]*e2[0]-e1[0]*e2[2];
+    n[2] = e1[0]*e2[1]-e1[1]*e2[0];
+}
+
+typedef struct {
+    unsigned int from;  // collapsed into to
+    unsigned int to;
+    double cost;
+} glib_collapse_t;
+
+static int glib_collapse_compare(const void* a, const void* b){
+    double ca = ((const glib_collapse_t*)a)->cost, cb = ((const glib_collapse_t*)b)->cost;
+    return ca<cb?-1:(ca>cb?1:0);
+}
+
+static int glib_u64_compare(const void* a, const void* b){
+    unsigned long long ua = *(const unsigned long long*)a, ub = *(const unsigned long long*)b;
+    return ua<ub?-1:(ua>ub?1:0);
+}
+
+typedef struct {
+    const float* positions;     // 3 floats per vertex
+    unsigned int vertex_count;
+    glib_quadric_t* quadrics;
+    bool* locked;               // border, seam and non manifold vertices are never moved
+    // vertex -> triangles, rebuilt for every pass
+    unsigned int* adjacency_offsets;
+    unsigned int* adjacency;
+    unsigned int* remap;
+    bool* touched;
+} glib_simplifier_t;
+
+static void glib_simplifier_adjacency(glib_simplifier_t* s, const unsigned int* indices, unsigned int index_count){
+    memset(s->adjacency_offsets, 0, sizeof(unsigned int)*(s->vertex_count+1));
+    for(unsigned int i = 0; i<index_count; i++){
+        s->adjacency_offsets[indices[i]+1]++;
+    }
+    for(unsigned int v = 0; v<s->vertex_count; v++){
+        s->adjacency_offsets[v+1] += s->adjacency_offsets[v];
+    }
+    // the offsets are moved to the ends while the triangles are written, then back
+    for(unsigned int i = 0; i<index_count; i++){
+        s->adjacency[s->adjacency_offsets[indices[i]]++] = i/3;
+    }
+    for(unsigned int v = s->vertex_count; v>0; v--){
+        s->adjacency_offsets[v] = s->adjacency_offsets[v-1];
+    }
+    s->adjacency_offsets[0] = 0;
+}
+
+// would moving from to the position of to flip a triangle around from
+static bool glib_collapse_flips(glib_simplifier_t* s, const unsigned int* indices, unsigned int from, unsigned int to){
+    for(unsigned int a = s->adjacency_offsets[from]; a<s->adjacency_offsets[from+1]; a++){
+        const unsigned int* tri = indices+s->adjacency[a]*3;
+        if(tri[0]==to || tri[1]==to || tri[2]==to){
+            continue;
+        }
+        const float* p[3];
+        const float* q[3];
+        for(int c = 0; c<3; c++){
+            p[c] = s->positions+(size_t)tri[c]*3;
+            q[c] = tri[c]==from?s->positions+(size_t)to*3:p[c];
+        }
+        double before[3], after[3];
+        glib_triangle_normal(p[0], p[1], p[2], before);
+        glib_triangle_normal(q[0], q[1], q[2], after);
+        if(before[0]*after[0]+before[1]*after[1]+before[2]*after[2]<=0.0){
+            return true;
+        }
+    }
+    return false;
+}
+
+// collapse edges of the cheapest cost until the triangles are at most target_count/3, returns the new index count
+static unsigned int glib_simplify(glib_simplifier_t* s, unsigned int* indices, unsigned int index_count, unsigned int target_count, double* max_error){
+    glib_collapse_t* collapses = (glib_collapse_t*)malloc(sizeof(glib_collapse_t)*(index_count?index_count:1)*2);
+    if(!collapses) fputs("memory alloc fails",stderr),exit(1);
+
+    while(index_count>target_count){
+        glib_simplifier_adjacency(s, indices, index_count);
+
+        // both directions of every edge, from an unlocked vertex
+        unsigned int collapse_count = 0;
+        for(unsigned int i = 0; i<index_count; i++){
+            unsigned int a = indices[i];
+            unsigned int b = indices[i-i%3+(i+1)%3];
+            for(int dir = 0; dir<2; dir++){
+                unsigned int from = dir?b:a, to = dir?a:b;
+                if(!s->locked[from]){
+                    glib_collapse_t* c = &collapses[collapse_count++];
+                    c->from = from;
+                    c->to = to;
+                    c->cost = glib_quadric_error(&s->quadrics[from], &s->quadrics[to], s->positions+(size_t)to*3);
+                }
+            }
+        }
+        qsort(collapses, collapse_count, sizeof(glib_collapse_t), glib_collapse_compare);
+
+        // the neighbourhood of a collapse is touched, so the adjacency stays valid in the pass
+        for(unsigned int v = 0; v<s->vertex_count; v++){
+            s->remap[v] = v;
+            s->touched[v] = false;
+        }
+        unsigned int removed = 0;
+        unsigned int collapsed = 0;
+        for(unsigned int i = 0; i<collapse_count && index_count-removed*3>target_count; i++){
+            glib_collapse_t* c = &collapses[i];
+            if(s->touched[c->from] || s->touched[c->to] || glib_collapse_flips(s, indices, c->from, c->to)){
+                continue;
+            }
+            s->remap[c->from] = c->to;
+            glib_quadric_add(&s->quadrics[c->to], &s->quadrics[c->from]);
+            if(c->cost>*max_error){
+                *max_error = c->cost;
+            }
+            for(unsigned int a = s->adjacency_offsets[c->from]; a<s->adjacency_offsets[c->from+1]; a++){
+                const unsigned int* tri = indices+s->adjacency[a]*3;
+                if(tri[0]==c->to || tri[1]==c->to || tri[2]==c->to){
+                    removed++;
+                }
+                s->touched[tri[0]] = true;
+                s->touched[tri[1]] = true;
+                s->touched[tri[2]] = true;
+            }
+            collapsed++;
+        }
+        if(collapsed==0){
+            break;
+        }
+
+        // the collapsed triangles are dropped
+        unsigned int written = 0;
+        for(unsigned int i = 0; i<index_count; i += 3){
+            unsigned int a = s->remap[indices[i]], b = s->remap[indices[i+1]], c = s->remap[indices[i+2]];
+            if(a!=b && b!=c && a!=c){
+                indices[written++] = a;
+                indices[written++] = b;
+                indices[written++] = c;
+            }
+        }
+        index_count = written;
+    }
+    free(collapses);
+    return index_count;
+}
+
+// the vertices which share a position with another vertex or lie on an open or non manifold edge
+static void glib_simplifier_lock(glib_simplifier_t* s, const unsigned int* indices, unsigned int index_count){
+    // the first vertex of each position, with open addressing kept at most half full
+    unsigned int* canonical = (unsigned int*)malloc(sizeof(unsigned int)*(s->vertex_count?s->vertex_count:1));
+    unsigned int slot_cap = 16;
+    while(slot_cap<s->vertex_count*2) slot_cap *= 2;
+    unsigned int* slots = (unsigned int*)malloc(sizeof(unsigned int)*slot_cap);
+    if(!canonical || !slots) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<slot_cap; i++){
+        slots[i] = GLIB_HASH_EMPTY;
+    }
+    for(unsigned int v = 0; v<s->vertex_count; v++){
+        const float* p = s->positions+(size_t)v*3;
+        unsigned int bits[3];
+        memcpy(bits, p, sizeof(bits));
+        unsigned int slot = glib_hash_index(bits[0], bits[1], bits[2])&(slot_cap-1);
+        while(slots[slot]!=GLIB_HASH_EMPTY && memcmp(s->positions+(size_t)slots[slot]*3, p, sizeof(float)*3)!=0){
+            slot = (slot+1)&(slot_cap-1);
+        }
+        if(slots[slot]==GLIB_HASH_EMPTY){
+            slots[slot] = v;
+        }else{
+            // a seam, both sides are kept
+            s->locked[slots[slot]] = true;
+            s->locked[v] = true;
+        }
+        canonical[v] = slots[slot];
+    }
+    free(slots);
+
+    // an edge of one position pair has to be used by exactly two triangles
+    unsigned long long* edges = (unsigned long long*)malloc(sizeof(unsigned long long)*(index_count?index_count:1));
+    if(!edges) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<index_count; i++){
+        unsigned int a = canonical[indices[i]];
+        unsigned int b = canonical[indices[i-i%3+(i+1)%3]];
+        edges[i] = a<b?((unsigned long long)a<<32)|b:((unsigned long long)b<<32)|a;
+    }
+    qsort(edges, index_count, sizeof(unsigned long long), glib_u64_compare);
+    for(unsigned int i = 0; i<index_count;){
+        unsigned int run = 1;
+        while(i+run<index_count && edges[i+run]==edges[i]) run++;
+        if(run!=2){
+            unsigned int a = (unsigned int)(edges[i]>>32), b = (unsigned int)edges[i];
+            s->locked[a] = true;
+            s->locked[b] = true;
+        }
+        i += run;
+    }
+    // the locks of the positions go to every vertex of them
+    for(unsigned int v = 0; v<s->vertex_count; v++){
+        if(s->locked[canonical[v]]){
+            s->locked[v] = true;
+        }
+    }
+    free(edges);
+    free(canonical);
+}
+
+unsigned int glib_build_obj_lods(glib_obj_t* obj, unsigned int lod_count){
+    if(lod_count==0){
+        return 0;
+    }
+    if(obj->index_len==0 || obj->EBO==0){
+        fprintf(stderr, "[WARN] Only an indexed object can have LODs\n");
+        return 0;
+    }
+    const glib_vertex_attrib_t* position = glib_position_attrib(&obj->layout);
+    if(position==NULL){
+        fprintf(stderr, "[WARN] The object has no position attribute for the LODs\n");
+        return 0;
+    }
+    if(lod_count>GLIB_MAX_LODS){
+        lod_count = GLIB_MAX_LODS;
+    }
+    glib_profile_scope_t scope = glib_profile_begin("glib_build_obj_lods", false);
+
+    // the CPU side data if the object owns it, otherwise the buffers are read back as the arrays of the caller may be gone
+    size_t stride = obj->layout.stride;
+    size_t index_size = glib_index_size(obj->index_type);
+    bool read_back_vertices = !obj->owns_vertices || obj->vertices==NULL;
+    bool read_back_indices = !obj->owns_indices || obj->indices==NULL;
+    unsigned char* vertex_data = (unsigned char*)obj->vertices;
+    unsigned char* index_data = (unsigned char*)obj->indices;
+    if(read_back_vertices){
+        vertex_data = (unsigned char*)malloc(stride*obj->vertex_count+1);
+        if(!vertex_data) fputs("memory alloc fails",stderr),exit(1);
+        glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+        glGetBufferSubData(GL_ARRAY_BUFFER, glib_obj_region_start(obj), stride*obj->vertex_count, vertex_data);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if(read_back_indices){
+        index_data = (unsigned char*)malloc(index_size*obj->index_len);
+        if(!index_data) fputs("memory alloc fails",stderr),exit(1);
+        glib_bind_vao(obj->VAO);
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, index_size*obj->index_len, index_data);
+    }
+
+    glib_simplifier_t s;
+    memset(&s, 0, sizeof(s));
+    s.vertex_count = obj->vertex_count;
+    float* positions = (float*)malloc(sizeof(float)*3*(s.vertex_count?s.vertex_count:1));
+    unsigned int* indices = (unsigned int*)malloc(sizeof(unsigned int)*obj->index_len);
+    // the indices of every LOD after the full mesh
+    unsigned int* chain = (unsigned int*)malloc(sizeof(unsigned int)*obj->index_len*lod_count);
+    s.quadrics = (glib_quadric_t*)calloc(s.vertex_count+1, sizeof(glib_quadric_t));
+    s.locked = (bool*)calloc(s.vertex_count+1, sizeof(bool));
+    s.adjacency_offsets = (unsigned int*)malloc(sizeof(unsigned int)*(s.vertex_count+1));
+    s.adjacency = (unsigned int*)malloc(sizeof(unsigned int)*obj->index_len);
+    s.remap = (unsigned int*)malloc(sizeof(unsigned int)*(s.vertex_count+1));
+    s.touched = (bool*)malloc(sizeof(bool)*(s.vertex_count+1));
+    if(!positions || !indices || !chain || !s.quadrics || !s.locked || !s.adjacency_offsets || !s.adjacency || !s.remap || !s.touched) fputs("memory alloc fails",stderr),exit(1);
+    s.positions = positions;
+
+    for(unsigned int v = 0; v<s.vertex_count; v++){
+        const unsigned char* p = vertex_data+v*stride+position->offset;
+        for(int c = 0; c<3; c++){
+            positions[v*3+c] = c<position->size?glib_read_attrib_component(p, position, c):0.0f;
+        }
+    }
+    // triangles with an index out of the vertices are dropped
+    unsigned int index_count = 0;
+    for(unsigned int i = 0; i+2<obj->index_len; i += 3){
+        unsigned int tri[3];
+        for(int c = 0; c<3; c++){
+            tri[c] = obj->index_type==GLIB_INDEX_UINT16?((unsigned short*)index_data)[i+c]:((unsigned int*)index_data)[i+c];
+        }
+        if(tri[0]<s.vertex_count && tri[1]<s.vertex_count && tri[2]<s.vertex_count){
+            memcpy(indices+index_count, tri, sizeof(tri));
+            index_count += 3;
+        }
+    }
+
+    for(unsigned int i = 0; i<index_count; i += 3){
+        double n[3];
+        const float* a = positions+(size_t)indices[i]*3;
+        glib_triangle_normal(a, positions+(size_t)indices[i+1]*3, positions+(size_t)indices[i+2]*3, n);
+        double length = sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+        if(length<=0.0){
+            continue;
+        }
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+        glib_quadric_t plane;
+        memset(&plane, 0, sizeof(plane));
+        glib_quadric_add_plane(&plane, n[0], n[1], n[2], -(n[0]*a[0]+n[1]*a[1]+n[2]*a[2]));
+        for(int c = 0; c<3; c++){
+            glib_quadric_add(&s.quadrics[indices[i+c]], &plane);
+        }
+    }
+    glib_simplifier_lock(&s, indices, index_count);
+
+    obj->lods[0].first_index = 0;
+    obj->lods[0].index_count = obj->index_len;
+    obj->lods[0].error = 0.0f;
+    unsigned int built = 1;
+    unsigned int chain_len = 0;
+    double max_error = 0.0;
+    while(built<lod_count){
+        unsigned int target = (unsigned int)(index_count/3*GLIB_LOD_RATIO)*3;
+        unsigned int simplified = glib_simplify(&s, indices, index_count, target, &max_error);
+        // a LOD which saves less than a tenth is not worth its indices
+        if(simplified==0 || (unsigned long long)simplified*10>(unsigned long long)index_count*9){
+            break;
+        }
+        index_count = simplified;
+        memcpy(chain+chain_len, indices, sizeof(unsigned int)*index_count);
+        obj->lods[built].first_index = obj->index_len+chain_len;
+        obj->lods[built].index_count = index_count;
+        obj->lods[built].error = (float)sqrt(max_error);
+        chain_len += index_count;
+        built++;
+    }
+
+    // the LODs go after the indices of the object, in its index type
+    size_t total = (size_t)obj->index_len+chain_len;
+    unsigned char* all = (unsigned char*)malloc(index_size*total);
+    if(!all) fputs("memory alloc fails",stderr),exit(1);
+    memcpy(all, index_data, index_size*obj->index_len);
+    for(unsigned int i = 0; i<chain_len; i++){
+        if(obj->index_type==GLIB_INDEX_UINT16){
+            ((unsigned short*)all)[obj->index_len+i] = (unsigned short)chain[i];
+        }else{
+            ((unsigned int*)all)[obj->index_len+i] = chain[i];
+        }
+    }
+    glib_bind_vao(obj->VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj->EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size*total, all, glib_gl_buffer_usage(obj->usage));
+    obj->index_capacity = total;
+    obj->lod_count = built;
+    obj->lod = 0;
+
+    free(all);
+    if(read_back_vertices){
+        free(vertex_data);
+    }
+    if(read_back_indices){
+        free(index_data);
+    }
+    free(positions);
+    free(indices);
+    free(chain);
+    free(s.quadrics);
+    free(s.locked);
+    free(s.adjacency_offsets);
+    free(s.adjacency);
+    free(s.remap);
+    free(s.touched);
+    glib_profile_end(scope);
+    return built;
+}
+
+unsigned int glib_select_obj_lod(const glib_obj_t* obj, mat4 model, const glib_camera_t* camera, unsigned int current){
+    if(obj->lod_count<2){
+        return 0;
+    }
+    vec4 center = {
+        (obj->bounds_min[0]+obj->bounds_max[0])*0.5f,
+        (obj->bounds_min[1]+obj->bounds_max[1])*0.5f,
+        (obj->bounds_min[2]+obj->bounds_max[2])*0.5f,
+        1.0f,
+    };
+    vec4 world_center;
+    glm_mat4_mulv(model, center, world_center);
+    float scale = 0.0f;
+    for(int c = 0; c<3; c++){
+        float length = sqrtf(model[c][0]*model[c][0]+model[c][1]*model[c][1]+model[c][2]*model[c][2]);
+        scale = fmaxf(scale, length);
+    }
+    vec3 extent;
+    glm_vec3_sub((float*)obj->bounds_max, (float*)obj->bounds_min, extent);
+    float radius = glm_vec3_norm(extent)*0.5f*scale;
+    float distance = glm_vec3_distance(world_center, (float*)camera->position);
+    if(distance<=radius){
+        return 0;
+    }
+
+    // pixels of one object space unit at the distance of the bounding sphere
+    float pixels = scale/(distance*tanf(glm_rad(camera->zoom)*0.5f))*glib_window_height*0.5f;
+    unsigned int lod = 0;
+    for(unsigned int i = 1; i<obj->lod_count; i++){
+        // a coarser LOD has to be under the limit by the hysteresis, the current one and the finer ones may be over it by the same
+        float limit = GLIB_LOD_PIXEL_ERROR*(i<=current?1.0f+GLIB_LOD_HYSTERESIS:1.0f-GLIB_LOD_HYSTERESIS);
+        if(obj->lods[i].error*pixels>limit){
+            break;
+        }
+        lod = i;
+    }
+    return lod;
+}
+
+void glib_update_obj_lod(glib_obj_t* obj, mat4 model, const glib_camera_t* camera){
+    obj->lod = glib_select_obj_lod(obj, model, camera, obj->lod);
+}
+
+unsigned int glib_get_default_instanced_shader(void){
+    return glib_default_instanced_shader;
+}
+
+void glib_wired_draw(){
+    glib_set_polygon_mode(GL_LINE);
+}
+
+void glib_filled_draw(){
+    glib_set_polygon_mode(GL_FILL);
+}
+
+typedef struct {
+    char name[GLIB_UNIFORM_NAME_LEN];
+    unsigned int hash;
+    int location;
+    GLenum type;
+    // the last uploaded value, so repeated uploads of the same value can be skipped
+    bool has_value;
+    union {
+        int i;
+        float f;
+        double d;
+        float m[16];
+    } value;
+} glib_uniform_info_t;
+
+typedef struct {
+    glib_uniform_info_t* uniforms;
+    int uniform_count;
+    int uniform_cap;
+} glib_program_info_t;
+
+// indexed by the program ID
+glib_program_info_t* glib_program_infos = NULL;
+unsigned int glib_program_info_cap = 0;
+
+static glib_program_info_t* glib_get_program_info(unsigned int program_id){
+    if(program_id>=glib_program_info_cap || glib_program_infos[program_id].uniforms==NULL){
+        return NULL;
+    }
+    return &glib_program_infos[program_id];
+}
+
+static void glib_reflect_program(unsigned int program_id){
+    if(program_id>=glib_program_info_cap){
+        unsigned int new_cap = glib_program_info_cap?glib_program_info_cap:16;
+        while(new_cap<=program_id) new_cap *= 2;
+        glib_program_infos = (glib_program_info_t*)realloc(glib_program_infos, sizeof(glib_program_info_t)*new_cap);
+        if(!glib_program_infos) fputs("memory alloc fails",stderr),exit(1);
+        memset(glib_program_infos+glib_program_info_cap, 0, sizeof(glib_program_info_t)*(new_cap-glib_program_info_cap));
+        glib_program_info_cap = new_cap;
+    }
+
+    GLint count = 0;
+    glGetProgramiv(program_id, GL_ACTIVE_UNIFORMS, &count);
+
+    glib_program_info_t* info = &glib_program_infos[program_id];
+    free(info->uniforms);
+    // allocate at least one entry, a NULL table means the program is unknown
+    info->uniforms = (glib_uniform_info_t*)calloc(count>0?count:1, sizeof(glib_uniform_info_t));
+    if(!info->uniforms) fputs("memory alloc fails",stderr),exit(1);
+    info->uniform_count = 0;
+    info->uniform_cap = count>0?count:1;
+
+    for(GLint i = 0; i<count; i++){
+        glib_uniform_info_t* u = &info->uniforms[info->uniform_count];
+        GLint size;
+        GLsizei len;
+        glGetActiveUniform(program_id, i, GLIB_UNIFORM_NAME_LEN, &len, &size, &u->type, u->name);
+
+        u->location = glGetUniformLocation(program_id, u->name);
+        // uniforms in blocks has no location
+        if(u->location<0){
+            continue;
+        }
+        // arrays are reported as "name[0]", store them by their plain name, glib_get_uniform adds the other elements when they are asked for
+        size_t name_len = strlen(u->name);
+        if(name_len>3 && strcmp(u->name+name_len-3, "[0]")==0){
+            u->name[name_len-3] = '\0';
+        }
+        u->hash = glib_hash_str(u->name);
+        info->uniform_count++;
+    }
+}
+
+// 32 bytes, the driver specific program binary follows it
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int binary_format;
+    unsigned int binary_len;
+    unsigned long long key;
+    unsigned char reserved[8];
+} glib_program_header_t;
+
+char glib_shader_cache_dir[256] = GLIB_SHADER_CACHE_DIR;
+bool glib_shader_echo = false;
+
+void glib_set_shader_cache_dir(const char* dir){
+    if(!dir){
+        glib_shader_cache_dir[0] = '\0';
+        return;
+    }
+    snprintf(glib_shader_cache_dir, sizeof(glib_shader_cache_dir), "%s", dir);
+}
+
+void glib_set_shader_echo(bool enabled){
+    glib_shader_echo = enabled;
+}
+
+static unsigned long long glib_hash_str64(unsigned long long hash, const char* str){
+    // FNV-1a, the terminating zero is hashed too, so "ab"+"c" differs from "a"+"bc"
+    if(!str){
+        str = "";
+    }
+    do{
+        hash ^= (unsigned char)*str;
+        hash *= 1099511628211ull;
+    }while(*str++);
+    return hash;
+}
+
+// the binary is only valid for the same sources on the same driver
+static unsigned long long glib_program_key(const char* vert_src, const char* frag_src){
+    unsigned long long hash = 14695981039346656037ull;
+    hash = glib_hash_str64(hash, vert_src);
+    hash = glib_hash_str64(hash, frag_src);
+    hash = glib_hash_str64(hash, (const char*)glGetString(GL_VENDOR));
+    hash = glib_hash_str64(hash, (const char*)glGetString(GL_RENDERER));
+    hash = glib_hash_str64(hash, (const char*)glGetString(GL_VERSION));
+    return hash;
+}
+
+static bool glib_program_cache_enabled(void){
+    if(glib_shader_cache_dir[0]=='\0' || !GLEW_ARB_get_program_binary){
+        return false;
+    }
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    return format_count>0;
+}
+
+static void glib_program_cache_path(char* path, size_t path_len, unsigned long long key){
+    snprintf(path, path_len, "%s/%016llx%s", glib_shader_cache_dir, key, GLIB_PROGRAM_CACHE_EXT);
+}
+
+// returns 0 if there is no usable binary, e.g. the driver rejects it after an update
+static GLuint glib_load_program_binary(unsigned long long key){
+    char path[320];
+    glib_program_cache_path(path, sizeof(path), key);
+
+    glib_mapped_file_t file;
+    if(!glib_map_file(path, &file)){
+        return 0;
+    }
+
+    const glib_program_header_t* header = (const glib_program_header_t*)file.data;
+    GLuint program_id = 0;
+    if(file.size>=sizeof(glib_program_header_t) &&
+        header->magic==GLIB_PROGRAM_MAGIC &&
+        header->version==GLIB_PROGRAM_VERSION &&
+        header->key==key &&
+        header->binary_len<=file.size-sizeof(glib_program_header_t)){
+        program_id = glCreateProgram();
+        glProgramBinary(program_id, header->binary_format, (const char*)file.data+sizeof(glib_program_header_t), header->binary_len);
+
+        GLint is_linked = 0;
+        glGetProgramiv(program_id, GL_LINK_STATUS, &is_linked);
+        if(is_linked == GL_FALSE){
+            glDeleteProgram(program_id);
+            program_id = 0;
+        }
+    }
+    glib_unmap_file(&file);
+
+    if(program_id==0){
+        remove(path);
+    }
+    return program_id;
+}
+
+static void glib_save_program_binary(GLuint program_id, unsigned long long key){
+    GLint binary_len = 0;
+    glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &binary_len);
+    if(binary_len<=0){
+        return;
+    }
+
+    glib_program_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = GLIB_PROGRAM_MAGIC;
+    header.version = GLIB_PROGRAM_VERSION;
+    header.key = key;
+
+    char* binary = (char*)malloc(binary_len);
+    if(!binary) fputs("memory alloc fails",stderr),exit(1);
+    GLenum binary_format;
+    GLsizei len = 0;
+    glGetProgramBinary(program_id, binary_len, &len, &binary_format, binary);
+    header.binary_format = binary_format;
+    header.binary_len = len;
+
+#ifdef _WIN32
+    CreateDirectoryA(glib_shader_cache_dir, NULL);
+#else
+    mkdir(glib_shader_cache_dir, 0755);
+#endif
+
+    char path[320];
+    glib_program_cache_path(path, sizeof(path), key);
+    FILE* fp = fopen(path, "wb");
+    bool ok = fp!=NULL;
+    if(fp){
+        ok = fwrite(&header, sizeof(header), 1, fp)==1;
+        ok = ok && fwrite(binary, 1, len, fp)==(size_t)len;
+        ok = (fclose(fp)==0) && ok;
+        if(!ok){
+            remove(path);
+        }
+    }
+    if(!ok){
+        fprintf(stderr, "[WARN] Cannot write shader cache. %s\n", path);
+    }
+    free(binary);
+}
+
+static GLuint glib_compile_shader_source(GLenum shader_type, const char* shader_source, const char* name){
+    GLint is_compiled = 0;
+    if(glib_shader_echo){
+        printf("%s: %s\n", name, shader_source);
+    }
+
+    int shader_id = glCreateShader(shader_type);
+    if(shader_id == 0) {
+        printf("COULD NOT LOAD SHADER: %s!\n", name);
+        exit(-1);
+    }
+
+    glShaderSource(shader_id, 1, (const char**)&shader_source, NULL);
+    glCompileShader(shader_id);
+    glGetShaderiv(shader_id, GL_COMPILE_STATUS, &is_compiled);
+
+    if(is_compiled == GL_FALSE) {
+        GLint max_len = 0;
+        char info_log[1024];
+	    glGetShaderiv(shader_id, GL_INFO_LOG_LENGTH, &max_len);
+        glGetShaderInfoLog(shader_id, sizeof(info_log), &max_len, info_log);
+
+        printf("%s\n", info_log);
+        fprintf(stderr, "Shader Compiler Error: %s\n", name);
+        glDeleteShader(shader_id);
+        exit(-1);
+    }
+
+    return shader_id;
+}
+
+int compile_shader(GLenum shader_type, const char* shader_thing, int from_memory){
+    if(from_memory){
+        return glib_compile_shader_source(shader_type, shader_thing, "<memory>");
+    }
+    const char* packed = (const char*)glib_find_packed(shader_thing, NULL);
+    if(packed){
+        return glib_compile_shader_source(shader_type, packed, shader_thing);
+    }
+    /* Calls the Function that loads the Shader source code from a file */
+    char* shader_source = glib_read_from_file(shader_thing);
+    GLuint shader_id = glib_compile_shader_source(shader_type, shader_source, shader_thing);
+    free(shader_source);
+    return shader_id;
+}
+
+static GLuint glib_link_program(GLuint vertex_shader_id, GLuint fragment_shader_id, bool retrievable){
+    GLuint program_id = 0;
+    GLint is_linked = 0;
+    GLint max_len = 0;
+    char info_log[1024];
+
+    program_id = glCreateProgram();
+    if(retrievable){
+        glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glAttachShader(program_id, vertex_shader_id);
+    glAttachShader(program_id, fragment_shader_id);
+
+    glLinkProgram(program_id);
+
+    glGetProgramiv(program_id, GL_LINK_STATUS, &is_linked);
+    if(is_linked == GL_FALSE) {
+        printf("Shader Program Linker Error\n");
+        
+	    glGetProgramiv(program_id, GL_INFO_LOG_LENGTH, &max_len);
+        glGetProgramInfoLog(program_id, sizeof(info_log), &max_len, info_log);
+
+        printf("%s\n", info_log);
+
+        glDeleteProgram(program_id);
+
+        glDeleteShader(vertex_shader_id);
+        glDeleteShader(fragment_shader_id);
+
+        exit(-1);
+    }
+
+    glDetachShader(program_id, vertex_shader_id);
+    glDetachShader(program_id, fragment_shader_id);
+
+    glDeleteShader(vertex_shader_id);
+    glDeleteShader(fragment_shader_id);
+
+    glib_reflect_program(program_id);
+    glib_register_shader(program_id);
+
+    return program_id;
+}
+
+int link_shader(GLuint vertex_shader_id, GLuint fragment_shader_id){
+    return glib_link_program(vertex_shader_id, fragment_shader_id, false);
+}
+
+// loads the program from the binary cache, or compiles it and fills the cache
+static unsigned int glib_build_program(const char* vert_src, const char* frag_src, const char* vert_name, const char* frag_name){
+    bool use_cache = glib_program_cache_enabled();
+    unsigned long long key = 0;
+    if(use_cache){
+        key = glib_program_key(vert_src, frag_src);
+        glib_profile_scope_t scope = glib_profile_begin("shader binary load", false);
+        GLuint program_id = glib_load_program_binary(key);
+        glib_profile_end(scope);
+        if(program_id){
+            glib_reflect_program(program_id);
+            glib_register_shader(program_id);
+            return program_id;
+        }
+    }
+
+    glib_profile_scope_t scope = glib_profile_begin("shader compile", false);
+    GLuint vert_id = glib_compile_shader_source(GL_VERTEX_SHADER, vert_src, vert_name);
+    GLuint frag_id = glib_compile_shader_source(GL_FRAGMENT_SHADER, frag_src, frag_name);
+    glib_profile_end(scope);
+
+    scope = glib_profile_begin("shader link", false);
+    GLuint program_id = glib_link_program(vert_id, frag_id, use_cache);
+    glib_profile_end(scope);
+
+    if(use_cache){
+        glib_save_program_binary(program_id, key);
+    }
+    return program_id;
+}
+
+unsigned int glib_create_shader(const char* vert_file_path, const char* frag_file_path){
+    // the packed sources are C strings in the mapping, only the loose files are read into memory
+    const char* packed_vert = (const char*)glib_find_packed(vert_file_path, NULL);
+    const char* packed_frag = (const char*)glib_find_packed(frag_file_path, NULL);
+    char* vert_src = packed_vert?NULL:glib_read_from_file(vert_file_path);
+    char* frag_src = packed_frag?NULL:glib_read_from_file(frag_file_path);
+
+    unsigned int program_id = glib_build_program(packed_vert?packed_vert:vert_src, packed_frag?packed_frag:frag_src, vert_file_path, frag_file_path);
+
+    free(vert_src);
+    free(frag_src);
+    return program_id;
+}
+
+unsigned int glib_create_shader_from_memory(const char* vert_src, const char* frag_src){
+    return glib_build_program(vert_src, frag_src, "<vertex shader>", "<fragment shader>");
+}
+
+void glib_use_shader(int shader_id){
+    glib_bind_program(shader_id);
+}
+
+void glib_set_uniform1i(int program_id, const char* name, int value){
+    glib_set_uniform1i_handle(glib_get_uniform(program_id, name), value);
+}
+
+void glib_set_uniform1f(int program_id, const char* name, float value){
+    glib_set_uniform1f_handle(glib_get_uniform(program_id, name), value);
+}
+
+void glib_set_uniform1d(int program_id, const char* name, double value){
+    glib_set_uniform1d_handle(glib_get_uniform(program_id, name), value);
+}
+
+void glib_set_unifrom_mat4(int program_id, const char* name, mat4 value){
+    glib_set_uniform_mat4_handle(glib_get_uniform(program_id, name), value);
+}
+
+static int glib_find_uniform(const glib_program_info_t* info, const char* name){
+    unsigned int hash = glib_hash_str(name);
+    for(int i = 0; i<info->uniform_count; i++){
+        if(info->uniforms[i].hash==hash && strcmp(info->uniforms[i].name, name)==0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+// an element of an array uniform, "name[0]" is the array itself, the other elements are located once and added to the table
+static int glib_add_uniform_element(unsigned int program_id, glib_program_info_t* info, const char* name){
+    size_t name_len = strlen(name);
+    if(name_len<4 || name_len>=GLIB_UNIFORM_NAME_LEN || name[name_len-1]!=']'){
+        return -1;
+    }
+    if(strcmp(name+name_len-3, "[0]")==0){
+        char array_name[GLIB_UNIFORM_NAME_LEN];
+        memcpy(array_name, name, name_len-3);
+        array_name[name_len-3] = '\0';
+        return glib_find_uniform(info, array_name);
+    }
+    GLint location = glGetUniformLocation(program_id, name);
+    if(location<0){
+        return -1;
+    }
+    if(info->uniform_count==info->uniform_cap){
+        info->uniform_cap *= 2;
+        info->uniforms = (glib_uniform_info_t*)realloc(info->uniforms, sizeof(glib_uniform_info_t)*info->uniform_cap);
+        if(!info->uniforms) fputs("memory alloc fails",stderr),exit(1);
+    }
+    glib_uniform_info_t* u = &info->uniforms[info->uniform_count];
+    memset(u, 0, sizeof(glib_uniform_info_t));
+    memcpy(u->name, name, name_len+1);
+    u->hash = glib_hash_str(name);
+    u->location = location;
+    u->type = GL_NONE;
+    return info->uniform_count++;
+}
+
+glib_uniform_handle_t glib_get_uniform(int program_id, const char* name){
+    glib_uniform_handle_t uniform = {program_id, -1};
+    glib_program_info_t* info = glib_get_program_info(program_id);
+    if(info==NULL){
+        return uniform;
+    }
+
+    uniform.index = glib_find_uniform(info, name);
+    if(uniform.index<0){
+        uniform.index = glib_add_uniform_element(program_id, info, name);
+    }
+    return uniform;
+}
+
+static glib_uniform_info_t* glib_get_uniform_info(glib_uniform_handle_t uniform){
+    glib_program_info_t* info = glib_get_program_info(uniform.program);
+    if(info==NULL || uniform.index<0 || uniform.index>=info->uniform_count){
+        return NULL;
+    }
+    return &info->uniforms[uniform.index];
+}
+
+void glib_set_uniform1i_handle(glib_uniform_handle_t uniform, int value){
+    glib_uniform_info_t* u = glib_get_uniform_info(uniform);
+    if(u==NULL || (u->has_value && u->value.i==value)){
+        return;
+    }
+    glUniform1i(u->location, value);
+    u->value.i = value;
+    u->has_value = true;
+}
+
+void glib_set_uniform1f_handle(glib_uniform_handle_t uniform, float value){
+    glib_uniform_info_t* u = glib_get_uniform_info(uniform);
+    if(u==NULL || (u->has_value && u->value.f==value)){
+        return;
+    }
+    glUniform1f(u->location, value);
+    u->value.f = value;
+    u->has_value = true;
+}
+
+void glib_set_uniform1d_handle(glib_uniform_handle_t uniform, double value){
+    glib_uniform_info_t* u = glib_get_uniform_info(uniform);
+    if(u==NULL || (u->has_value && u->value.d==value)){
+        return;
+    }
+    glUniform1d(u->location, value);
+    u->value.d = value;
+    u->has_value = true;
+}
+
+void glib_set_uniform_mat4_handle(glib_uniform_handle_t uniform, mat4 value){
+    glib_uniform_info_t* u = glib_get_uniform_info(uniform);
+    if(u==NULL || (u->has_value && memcmp(u->value.m, value, sizeof(u->value.m))==0)){
+        return;
+    }
+    glUniformMatrix4fv(u->location, 1, GL_FALSE, (float*)value);
+    memcpy(u->value.m, value, sizeof(u->value.m));
+    u->has_value = true;
+}
+
+static unsigned int glib_upload_texture_2d(const unsigned char* data, int width, int height, unsigned char has_alpha){
+    glib_profile_scope_t scope = glib_profile_begin("texture upload", true);
+    unsigned int tex;
+    glGenTextures(1, &tex);
+    glib_register_texture(tex);
+    glib_bind_texture(GLIB_TEX_SLOT0, tex);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, has_alpha?GL_RGBA:GL_RGB, width, height, 0, has_alpha?GL_RGBA:GL_RGB, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glib_profile_end(scope);
+    return tex;
+}
+
+// 64 bytes, the RGBA levels follow it from the largest one, each 16 byte aligned
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int width;
+    unsigned int height;
+    unsigned int level_count;
+    unsigned int has_alpha;
+    unsigned int source_hash;
+    unsigned int reserved0;
+    unsigned long long source_size;
+    long long source_mtime;
+    unsigned char reserved[16];
+} glib_texture_header_t;
+
+#define GLIB_TEXTURE_LEVEL_SIZE(W, H) ((((size_t)(W)*(H)*4)+15)&~(size_t)15)
+
+static unsigned int glib_mip_level_count(int width, int height){
+    unsigned int count = 1;
+    while(width>1 || height>1){
+        width = width>1?width/2:1;
+        height = height>1?height/2:1;
+        count++;
+    }
+    return count;
+}
+
+// 2x2 box filter of an RGBA image, the average of the vertical averages so the SSE2 and the scalar path give the same result
+static void glib_downsample_rgba(const unsigned char* src, int src_width, int src_height, unsigned char* dst){
+    int dst_width = src_width>1?src_width/2:1;
+    int dst_height = src_height>1?src_height/2:1;
+    for(int y = 0; y<dst_height; y++){
+        const unsigned char* row0 = src+(size_t)(2*y<src_height?2*y:src_height-1)*src_width*4;
+        const unsigned char* row1 = src+(size_t)(2*y+1<src_height?2*y+1:src_height-1)*src_width*4;
+        unsigned char* out = dst+(size_t)y*dst_width*4;
+        int x = 0;
+#ifdef __SSE2__
+        // 8 source pixels -> 4 destination pixels
+        for(; src_width>1 && x+4<=dst_width; x+=4){
+            __m128i top0 = _mm_loadu_si128((const __m128i*)(row0+x*8));
+            __m128i top1 = _mm_loadu_si128((const __m128i*)(row0+x*8+16));
+            __m128i bottom0 = _mm_loadu_si128((const __m128i*)(row1+x*8));
+            __m128i bottom1 = _mm_loadu_si128((const __m128i*)(row1+x*8+16));
+            __m128 vertical0 = _mm_castsi128_ps(_mm_avg_epu8(top0, bottom0));
+            __m128 vertical1 = _mm_castsi128_ps(_mm_avg_epu8(top1, bottom1));
+            __m128i even = _mm_castps_si128(_mm_shuffle_ps(vertical0, vertical1, _MM_SHUFFLE(2, 0, 2, 0)));
+            __m128i odd = _mm_castps_si128(_mm_shuffle_ps(vertical0, vertical1, _MM_SHUFFLE(3, 1, 3, 1)));
+            _mm_storeu_si128((__m128i*)(out+x*4), _mm_avg_epu8(even, odd));
+        }
+#endif
+        for(; x<dst_width; x++){
+            int x0 = 2*x<src_width?2*x:src_width-1;
+            int x1 = 2*x+1<src_width?2*x+1:src_width-1;
+            for(int c = 0; c<4; c++){
+                int left = (row0[x0*4+c]+row1[x0*4+c]+1)>>1;
+                int right = (row0[x1*4+c]+row1[x1*4+c]+1)>>1;
+                out[x*4+c] = (unsigned char)((left+right+1)>>1);
+            }
+        }
+    }
+}
+
+// every level of an RGBA image in one buffer, laid out like in the texture cache file
+static unsigned char* glib_build_mip_chain(const unsigned char* pixels, int width, int height, unsigned int level_count, size_t* out_size){
+    size_t size = 0;
+    int w = width, h = height;
+    for(unsigned int level = 0; level<level_count; level++){
+        size += GLIB_TEXTURE_LEVEL_SIZE(w, h);
+        w = w>1?w/2:1;
+        h = h>1?h/2:1;
+    }
+
+    unsigned char* chain = (unsigned char*)malloc(size);
+    if(!chain) fputs("memory alloc fails",stderr),exit(1);
+    memcpy(chain, pixels, (size_t)width*height*4);
+
+    unsigned char* level_data = chain;
+    w = width, h = height;
+    for(unsigned int level = 1; level<level_count; level++){
+        unsigned char* next = level_data+GLIB_TEXTURE_LEVEL_SIZE(w, h);
+        glib_downsample_rgba(level_data, w, h, next);
+        level_data = next;
+        w = w>1?w/2:1;
+        h = h>1?h/2:1;
+    }
+    *out_size = size;
+    return chain;
+}
+
+static unsigned int glib_upload_mip_chain(const unsigned char* chain, int width, int height, unsigned int level_count, unsigned char has_alpha){
+    glib_profile_scope_t scope = glib_profile_begin("texture upload", true);
+    unsigned int tex;
+    glGenTextures(1, &tex);
+    glib_register_texture(tex);
+    glib_bind_texture(GLIB_TEX_SLOT0, tex);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, level_count>1?GL_LINEAR_MIPMAP_LINEAR:GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level_count-1);
+
+    // the levels are RGBA, the alpha is dropped by the internal format if the texture has none
+    int w = width, h = height;
+    for(unsigned int level = 0; level<level_count; level++){
+        glTexImage2D(GL_TEXTURE_2D, level, has_alpha?GL_RGBA:GL_RGB, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, chain);
+        chain += GLIB_TEXTURE_LEVEL_SIZE(w, h);
+        w = w>1?w/2:1;
+        h = h>1?h/2:1;
+    }
+    glib_profile_end(scope);
+    return tex;
+}
+
+// upload a texture cache in memory, the source checks are skipped for the packed caches
+static unsigned int glib_texture_from_cache(const void* data, size_t data_size, const glib_texture_header_t* source, bool check_source){
+    const glib_texture_header_t* header = (const glib_texture_header_t*)data;
+    bool valid = data_size>=sizeof(glib_texture_header_t) &&
+        header->magic==GLIB_TEXTURE_MAGIC &&
+        header->version==GLIB_TEXTURE_VERSION &&
+        header->has_alpha==source->has_alpha &&
+        (!check_source || (header->source_hash==source->source_hash &&
+        header->source_size==source->source_size &&
+        header->source_mtime==source->source_mtime)) &&
+        header->width>0 && header->height>0 &&
+        header->level_count==glib_mip_level_count(header->width, header->height);
+    if(valid){
+        size_t size = sizeof(glib_texture_header_t);
+        unsigned int w = header->width, h = header->height;
+        for(unsigned int level = 0; level<header->level_count; level++){
+            size += GLIB_TEXTURE_LEVEL_SIZE(w, h);
+            w = w>1?w/2:1;
+            h = h>1?h/2:1;
+        }
+        valid = size<=data_size;
+    }
+
+    if(!valid){
+        return 0;
+    }
+    return glib_upload_mip_chain((const unsigned char*)data+sizeof(glib_texture_header_t), header->width, header->height, header->level_count, header->has_alpha);
+}
+
+static unsigned int glib_read_texture_cache(const char* cache_path, const glib_texture_header_t* source){
+    glib_mapped_file_t file;
+    if(!glib_map_file(cache_path, &file)){
+        return 0;
+    }
+    unsigned int tex = glib_texture_from_cache(file.data, file.size, source, true);
+    glib_unmap_file(&file);
+    return tex;
+}
+
+// a mesh or texture cache which is made from the file as it is now, glib_write_pack packs only these
+static bool glib_cache_is_current(const char* file_path, const char* cache_path){
+    struct stat st;
+    glib_mapped_file_t cache;
+    if(stat(file_path, &st)!=0 || !glib_map_file(cache_path, &cache)){
+        return false;
+    }
+    const glib_mesh_header_t* mesh = (const glib_mesh_header_t*)cache.data;
+    const glib_texture_header_t* texture = (const glib_texture_header_t*)cache.data;
+    unsigned int hash = glib_hash_str(file_path);
+    bool current = false;
+    if(cache.size>=sizeof(glib_mesh_header_t) && mesh->magic==GLIB_MESH_MAGIC && mesh->version==GLIB_MESH_VERSION){
+        current = mesh->source_hash==hash && mesh->source_size==(unsigned long long)st.st_size && mesh->source_mtime==st.st_mtime;
+    }else if(cache.size>=sizeof(glib_texture_header_t) && texture->magic==GLIB_TEXTURE_MAGIC && texture->version==GLIB_TEXTURE_VERSION){
+        current = texture->source_hash==hash && texture->source_size==(unsigned long long)st.st_size && texture->source_mtime==st.st_mtime;
+    }
+    glib_unmap_file(&cache);
+    return current;
+}
+
+static bool glib_write_texture_cache(const char* cache_path, const glib_texture_header_t* header, const unsigned char* chain, size_t chain_size){
+    FILE* fp = fopen(cache_path, "wb");
+    if(!fp){
+        return false;
+    }
+    bool ok = fwrite(header, sizeof(glib_texture_header_t), 1, fp)==1;
+    ok = ok && fwrite(chain, 1, chain_size, fp)==chain_size;
+    ok = (fclose(fp)==0) && ok;
+    if(!ok){
+        remove(cache_path);
+    }
+    return ok;
+}
+
+unsigned int glib_load_texture_2d(const char* file_path, unsigned char has_alpha){
+    size_t packed_size = 0;
+    const unsigned char* packed = (const unsigned char*)glib_find_packed(file_path, &packed_size);
+    struct stat st;
+    bool on_disk = stat(file_path, &st)==0;
+    if(!packed && !on_disk){
+        fprintf(stderr, "Failed to load texture. %s\n", file_path);
+        exit(-1);
+    }
+
+    // the packed data has no time, the file on disk gives it if there is one, so the cache on disk fits both
+    glib_texture_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = GLIB_TEXTURE_MAGIC;
+    header.version = GLIB_TEXTURE_VERSION;
+    header.has_alpha = has_alpha?1:0;
+    header.source_hash = glib_hash_str(file_path);
+    header.source_size = packed?packed_size:(unsigned long long)st.st_size;
+    header.source_mtime = on_disk?st.st_mtime:0;
+
+    char* cache_path = glib_make_cache_path(file_path, GLIB_TEXTURE_CACHE_EXT);
+    unsigned int tex = 0;
+    if(packed){
+        // a pack is built at once, so its cache is used without the source checks
+        size_t cache_size;
+        const void* cache = glib_find_packed(cache_path, &cache_size);
+        tex = cache?glib_texture_from_cache(cache, cache_size, &header, false):0;
+    }
+    if(tex==0){
+        tex = glib_read_texture_cache(cache_path, &header);
+    }
+    if(tex==0){
+        int width, height, n_channels;
+        stbi_set_flip_vertically_on_load(1);
+        unsigned char *data = packed?stbi_load_from_memory(packed, (int)packed_size, &width, &height, &n_channels, 4):stbi_load(file_path, &width, &height, &n_channels, 4);
+        if(!data){
+            fprintf(stderr, "Failed to load texture. %s\n", file_path);
+            exit(-1);
+        }
+
+        header.width = width;
+        header.height = height;
+        header.level_count = glib_mip_level_count(width, height);
+        size_t chain_size;
+        unsigned char* chain = glib_build_mip_chain(data, width, height, header.level_count, &chain_size);
+        stbi_image_free(data);
+
+        tex = glib_upload_mip_chain(chain, width, height, header.level_count, header.has_alpha);
+        if(!glib_write_texture_cache(cache_path, &header, chain, chain_size)){
+            fprintf(stderr, "[WARN] Cannot write texture cache. %s\n", cache_path);
+        }
+        free(chain);
+    }
+    free(cache_path);
+
+    return tex;
+}
+
+unsigned int glib_load_texture_2d_from_memory(const char* raw_data, unsigned int data_len, unsigned char has_alpha){
+    int width, height, n_channels;
+    stbi_set_flip_vertically_on_load(1);
+    unsigned char *data = stbi_load_from_memory(raw_data, data_len, &width, &height, &n_channels, 0);
+    if(!data){
+        fprintf(stderr, "Failed to load texture. %p\n", raw_data);
+        exit(-1);
+    }
+    unsigned int tex = glib_upload_texture_2d(data, width, height, has_alpha);
+    stbi_image_free(data);
+
+    return tex;
+}
+
+void glib_use_texture_2d(unsigned int texture, glib_texture_slot slot){
+    if(slot<GLIB_TEX_SLOT0 || slot>=GLIB_TEX_SLOT_COUNT){
+        slot = GLIB_TEX_SLOT0;
+    }
+    glib_bind_texture(slot, texture);
+}
+
+typedef struct glib_texture_job_t {
+    char* file_path;
+    unsigned char has_alpha;
+    glib_texture_state state;
+    unsigned char* data;
+    int width, height;
+    unsigned int texture;
+    struct glib_texture_job_t* next;
+} glib_texture_job_t;
+
+typedef struct {
+    pthread_t threads[GLIB_TEXTURE_WORKERS];
+    pthread_mutex_t mutex;
+    pthread_cond_t job_cond;  // signaled when a job is queued or the workers has to stop
+    pthread_cond_t done_cond; // signaled when a job is decoded
+    // FIFO of the jobs waiting for decoding
+    glib_texture_job_t* queue_head;
+    glib_texture_job_t* queue_tail;
+    // FIFO of the decoded jobs waiting for upload
+    glib_texture_job_t* decoded_head;
+    glib_texture_job_t* decoded_tail;
+    // every job by handle, the handle is the index
+    glib_texture_job_t** jobs;
+    unsigned int job_count;
+    unsigned int job_cap;
+    bool running;
+    bool quit;
+} glib_texture_loader_t;
+
+glib_texture_loader_t glib_texture_loader;
+
+static void* glib_texture_worker(void* arg){
+    (void)arg;
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    for(;;){
+        while(glib_texture_loader.queue_head==NULL && !glib_texture_loader.quit){
+            pthread_cond_wait(&glib_texture_loader.job_cond, &glib_texture_loader.mutex);
+        }
+        if(glib_texture_loader.quit){
+            break;
+        }
+        glib_texture_job_t* job = glib_texture_loader.queue_head;
+        glib_texture_loader.queue_head = job->next;
+        if(glib_texture_loader.queue_head==NULL){
+            glib_texture_loader.queue_tail = NULL;
+        }
+        job->next = NULL;
+        pthread_mutex_unlock(&glib_texture_loader.mutex);
+
+        int n_channels;
+        glib_profile_scope_t scope = glib_profile_begin("texture decode", false);
+        size_t packed_size;
+        const unsigned char* packed = (const unsigned char*)glib_find_packed(job->file_path, &packed_size);
+        unsigned char* data = packed?stbi_load_from_memory(packed, (int)packed_size, &job->width, &job->height, &n_channels, 0):stbi_load(job->file_path, &job->width, &job->height, &n_channels, 0);
+        glib_profile_end(scope);
+
+        pthread_mutex_lock(&glib_texture_loader.mutex);
+        if(data){
+            job->data = data;
+            job->state = GLIB_TEXTURE_DECODED;
+            if(glib_texture_loader.decoded_tail){
+                glib_texture_loader.decoded_tail->next = job;
+            }else{
+                glib_texture_loader.decoded_head = job;
+            }
+            glib_texture_loader.decoded_tail = job;
+        }else{
+            fprintf(stderr, "Failed to load texture. %s\n", job->file_path);
+            job->state = GLIB_TEXTURE_FAILED;
+        }
+        pthread_cond_broadcast(&glib_texture_loader.done_cond);
+    }
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+    return NULL;
+}
+
+static void glib_start_texture_workers(void){
+    pthread_mutex_init(&glib_texture_loader.mutex, NULL);
+    pthread_cond_init(&glib_texture_loader.job_cond, NULL);
+    pthread_cond_init(&glib_texture_loader.done_cond, NULL);
+    // the flag is global in stb_image, set it once before any worker reads it
+    stbi_set_flip_vertically_on_load(1);
+    glib_texture_loader.quit = false;
+    for(int i = 0; i<GLIB_TEXTURE_WORKERS; i++){
+        if(pthread_create(&glib_texture_loader.threads[i], NULL, glib_texture_worker, NULL)!=0){
+            fprintf(stderr, "ERROR: cannot start texture worker\n");
+            exit(-1);
+        }
+    }
+    glib_texture_loader.running = true;
+}
+
+static void glib_stop_texture_workers(void){
+    if(!glib_texture_loader.running){
+        return;
+    }
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    glib_texture_loader.quit = true;
+    pthread_cond_broadcast(&glib_texture_loader.job_cond);
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+    for(int i = 0; i<GLIB_TEXTURE_WORKERS; i++){
+        pthread_join(glib_texture_loader.threads[i], NULL);
+    }
+    glib_texture_loader.running = false;
+}
+
+static glib_texture_job_t* glib_get_texture_job(glib_async_texture_t texture){
+    glib_texture_job_t* job = NULL;
+    if(glib_texture_loader.running){
+        pthread_mutex_lock(&glib_texture_loader.mutex);
+        if(texture<glib_texture_loader.job_count){
+            job = glib_texture_loader.jobs[texture];
+        }
+        pthread_mutex_unlock(&glib_texture_loader.mutex);
+    }
+    return job;
+}
+
+glib_async_texture_t glib_load_texture_2d_async(const char* file_path, unsigned char has_alpha){
+    if(!glib_texture_loader.running){
+        glib_start_texture_workers();
+    }
+
+    glib_texture_job_t* job = (glib_texture_job_t*)calloc(1, sizeof(glib_texture_job_t));
+    char* path = (char*)malloc(strlen(file_path)+1);
+    if(!job || !path) fputs("memory alloc fails",stderr),exit(1);
+    strcpy(path, file_path);
+    job->file_path = path;
+    job->has_alpha = has_alpha;
+    job->state = GLIB_TEXTURE_QUEUED;
+
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    if(glib_texture_loader.job_count==glib_texture_loader.job_cap){
+        glib_texture_loader.job_cap = glib_texture_loader.job_cap?glib_texture_loader.job_cap*2:64;
+        glib_texture_loader.jobs = (glib_texture_job_t**)realloc(glib_texture_loader.jobs, sizeof(glib_texture_job_t*)*glib_texture_loader.job_cap);
+        if(!glib_texture_loader.jobs) fputs("memory alloc fails",stderr),exit(1);
+    }
+    glib_async_texture_t handle = glib_texture_loader.job_count++;
+    glib_texture_loader.jobs[handle] = job;
+
+    if(glib_texture_loader.queue_tail){
+        glib_texture_loader.queue_tail->next = job;
+    }else{
+        glib_texture_loader.queue_head = job;
+    }
+    glib_texture_loader.queue_tail = job;
+    pthread_cond_signal(&glib_texture_loader.job_cond);
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+
+    return handle;
+}
+
+// upload the oldest decoded job, return false if there is nothing to upload
+static bool glib_upload_next_texture(void){
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    glib_texture_job_t* job = glib_texture_loader.decoded_head;
+    if(job){
+        glib_texture_loader.decoded_head = job->next;
+        if(glib_texture_loader.decoded_head==NULL){
+            glib_texture_loader.decoded_tail = NULL;
+        }
+        job->next = NULL;
+    }
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+    if(!job){
+        return false;
+    }
+
+    // only the main thread touches decoded jobs, so the upload runs without the lock
+    job->texture = glib_upload_texture_2d(job->data, job->width, job->height, job->has_alpha);
+    stbi_image_free(job->data);
+    job->data = NULL;
+
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    job->state = GLIB_TEXTURE_READY;
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+    return true;
+}
+
+void glib_process_texture_uploads(double budget){
+    if(!glib_texture_loader.running){
+        return;
+    }
+    double start = glfwGetTime();
+    while(glib_upload_next_texture()){
+        if(glfwGetTime()-start>=budget){
+            break;
+        }
+    }
+}
+
+void glib_set_texture_upload_budget(double budget){
+    glib_texture_upload_budget = budget;
+}
+
+unsigned int glib_get_async_texture(glib_async_texture_t texture){
+    if(glib_get_async_texture_state(texture)==GLIB_TEXTURE_READY){
+        // the texture ID is written before the state is set to ready
+        return glib_texture_loader.jobs[texture]->texture;
+    }
+    return glib_default_tex;
+}
+
+glib_texture_state glib_get_async_texture_state(glib_async_texture_t texture){
+    glib_texture_job_t* job = glib_get_texture_job(texture);
+    if(!job){
+        return GLIB_TEXTURE_FAILED;
+    }
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    glib_texture_state state = job->state;
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+    return state;
+}
+
+unsigned int glib_wait_async_texture(glib_async_texture_t texture){
+    glib_texture_job_t* job = glib_get_texture_job(texture);
+    if(!job){
+        return glib_default_tex;
+    }
+
+    pthread_mutex_lock(&glib_texture_loader.mutex);
+    while(job->state==GLIB_TEXTURE_QUEUED){
+        pthread_cond_wait(&glib_texture_loader.done_cond, &glib_texture_loader.mutex);
+    }
+    pthread_mutex_unlock(&glib_texture_loader.mutex);
+
+    // the decoded FIFO is uploaded in order, so everything before this job is uploaded too
+    while(job->state==GLIB_TEXTURE_DECODED){
+        glib_upload_next_texture();
+    }
+    return glib_get_async_texture(texture);
+}
+
+typedef struct {
+    unsigned char* pixels; // RGBA
+    int width, height;
+    int page;
+    int x, y;              // position of the image inside the padding
+} glib_atlas_image_t;
+
+typedef struct {
+    int x, y, width;
+} glib_skyline_node_t;
+
+typedef struct {
+    glib_skyline_node_t* nodes;
+    int node_count;
+    unsigned char* pixels;
+    unsigned int texture;
+} glib_atlas_page_t;
+
+struct glib_atlas_t {
+    int page_width, page_height, padding;
+    int channels;           // bytes per pixel of the pages, 4 for the RGBA images, 1 for the glyphs of a font
+    glib_atlas_image_t* images;
+    int image_count;
+    int image_cap;
+    glib_atlas_page_t* pages;
+    int page_count;
+    bool built;
+};
+
+glib_atlas_t* glib_create_atlas(int page_width, int page_height, int padding){
+    glib_atlas_t* atlas = (glib_atlas_t*)calloc(1, sizeof(glib_atlas_t));
+    if(!atlas) fputs("memory alloc fails",stderr),exit(1);
+    atlas->page_width = page_width;
+    atlas->page_height = page_height;
+    atlas->padding = padding<0?0:padding;
+    atlas->channels = 4;
+    return atlas;
+}
+
+int glib_atlas_add_image_from_memory(glib_atlas_t* atlas, const unsigned char* pixels, int width, int height){
+    if(atlas->built){
+        fprintf(stderr, "ERROR: the atlas is already built\n");
+        exit(-1);
+    }
+    if(width+2*atlas->padding>atlas->page_width || height+2*atlas->padding>atlas->page_height){
+        fprintf(stderr, "ERROR: %dx%d image does not fit into a %dx%d atlas page\n", width, height, atlas->page_width, atlas->page_height);
+        exit(-1);
+    }
+    if(atlas->image_count==atlas->image_cap){
+        atlas->image_cap = atlas->image_cap?atlas->image_cap*2:64;
+        atlas->images = (glib_atlas_image_t*)realloc(atlas->images, sizeof(glib_atlas_image_t)*atlas->image_cap);
+        if(!atlas->images) fputs("memory alloc fails",stderr),exit(1);
+    }
+    glib_atlas_image_t* image = &atlas->images[atlas->image_count];
+    image->pixels = (unsigned char*)malloc((size_t)width*height*4);
+    if(!image->pixels) fputs("memory alloc fails",stderr),exit(1);
+    memcpy(image->pixels, pixels, (size_t)width*height*4);
+    image->width = width;
+    image->height = height;
+    image->page = -1;
+    return atlas->image_count++;
+}
+
+int glib_atlas_add_image(glib_atlas_t* atlas, const char* file_path){
+    int width, height, n_channels;
+    stbi_set_flip_vertically_on_load(1);
+    size_t packed_size;
+    const unsigned char* packed = (const unsigned char*)glib_find_packed(file_path, &packed_size);
+    unsigned char *data = packed?stbi_load_from_memory(packed, (int)packed_size, &width, &height, &n_channels, 4):stbi_load(file_path, &width, &height, &n_channels, 4);
+    if(!data){
+        fprintf(stderr, "Failed to load texture. %s\n", file_path);
+        exit(-1);
+    }
+    int region = glib_atlas_add_image_from_memory(atlas, data, width, height);
+    stbi_image_free(data);
+    return region;
+}
+
+// lowest y where a width wide rect can sit starting at the node, -1 if it does not fit
+static int glib_skyline_fit(glib_atlas_t* atlas, glib_atlas_page_t* page, int node, int width, int height){
+    int x = page->nodes[node].x;
+    if(x+width>atlas->page_width){
+        return -1;
+    }
+    int y = 0;
+    int width_left = width;
+    for(int i = node; width_left>0; i++){
+        if(page->nodes[i].y>y){
+            y = page->nodes[i].y;
+        }
+        width_left -= page->nodes[i].width;
+    }
+    if(y+height>atlas->page_height){
+        return -1;
+    }
+    return y;
+}
+
+static bool glib_skyline_insert(glib_atlas_t* atlas, glib_atlas_page_t* page, int width, int height, int* out_x, int* out_y){
+    int best = -1;
+    int best_y = atlas->page_height;
+    int best_width = atlas->page_width+1;
+    for(int i = 0; i<page->node_count; i++){
+        int y = glib_skyline_fit(atlas, page, i, width, height);
+        // bottom left rule, the narrower segment wins a tie
+        if(y>=0 && (y<best_y || (y==best_y && page->nodes[i].width<best_width))){
+            best = i;
+            best_y = y;
+            best_width = page->nodes[i].width;
+        }
+    }
+    if(best<0){
+        return false;
+    }
+
+    // the new segment is at most one more node than before
+    page->nodes = (glib_skyline_node_t*)realloc(page->nodes, sizeof(glib_skyline_node_t)*(page->node_count+1));
+    if(!page->nodes) fputs("memory alloc fails",stderr),exit(1);
+    memmove(&page->nodes[best+1], &page->nodes[best], sizeof(glib_skyline_node_t)*(page->node_count-best));
+    page->node_count++;
+    glib_skyline_node_t node = {page->nodes[best+1].x, best_y+height, width};
+    page->nodes[best] = node;
+
+    // cut the segments which are now under the new one
+    for(int i = best+1; i<page->node_count; i++){
+        int covered = page->nodes[i-1].x+page->nodes[i-1].width-page->nodes[i].x;
+        if(covered<=0){
+            break;
+        }
+        page->nodes[i].x += covered;
+        page->nodes[i].width -= covered;
+        if(page->nodes[i].width>0){
+            break;
+        }
+        memmove(&page->nodes[i], &page->nodes[i+1], sizeof(glib_skyline_node_t)*(page->node_count-i-1));
+        page->node_count--;
+        i--;
+    }
+    // merge the neighbours at the same height
+    for(int i = 0; i<page->node_count-1; i++){
+        if(page->nodes[i].y==page->nodes[i+1].y){
+            page->nodes[i].width += page->nodes[i+1].width;
+            memmove(&page->nodes[i+1], &page->nodes[i+2], sizeof(glib_skyline_node_t)*(page->node_count-i-2));
+            page->node_count--;
+            i--;
+        }
+    }
+
+    *out_x = node.x;
+    *out_y = best_y;
+    return true;
+}
+
+static glib_atlas_page_t* glib_atlas_new_page(glib_atlas_t* atlas){
+    atlas->pages = (glib_atlas_page_t*)realloc(atlas->pages, sizeof(glib_atlas_page_t)*(atlas->page_count+1));
+    if(!atlas->pages) fputs("memory alloc fails",stderr),exit(1);
+    glib_atlas_page_t* page = &atlas->pages[atlas->page_count++];
+    page->nodes = (glib_skyline_node_t*)malloc(sizeof(glib_skyline_node_t));
+    page->pixels = (unsigned char*)calloc((size_t)atlas->page_width*atlas->page_height, atlas->channels);
+    if(!page->nodes || !page->pixels) fputs("memory alloc fails",stderr),exit(1);
+    page->nodes[0].x = 0;
+    page->nodes[0].y = 0;
+    page->nodes[0].width = atlas->page_width;
+    page->node_count = 1;
+    page->texture = 0;
+    return page;
+}
+
+// copy the image into the page and extrude its edge pixels into the padding
+static void glib_atlas_blit(glib_atlas_t* atlas, glib_atlas_image_t* image){
+    unsigned char* dst = atlas->pages[image->page].pixels;
+    int pad = atlas->padding;
+    for(int y = -pad; y<image->height+pad; y++){
+        int src_y = y<0?0:(y>=image->height?image->height-1:y);
+        for(int x = -pad; x<image->width+pad; x++){
+            int src_x = x<0?0:(x>=image->width?image->width-1:x);
+            memcpy(dst+(((size_t)(image->y+y)*atlas->page_width+image->x+x)*4), image->pixels+(((size_t)src_y*image->width+src_x)*4), 4);
+        }
+    }
+}
+
+static int glib_atlas_compare_height(const void* a, const void* b){
+    const glib_atlas_image_t* image_a = *(const glib_atlas_image_t* const*)a;
+    const glib_atlas_image_t* image_b = *(const glib_atlas_image_t* const*)b;
+    if(image_a->height!=image_b->height){
+        return image_b->height-image_a->height;
+    }
+    return image_b->width-image_a->width;
+}
+
+int glib_atlas_build(glib_atlas_t* atlas){
+    if(atlas->built){
+        return atlas->page_count;
+    }
+
+    // the tallest images first keeps the skyline flat
+    glib_atlas_image_t** order = (glib_atlas_image_t**)malloc(sizeof(glib_atlas_image_t*)*(atlas->image_count?atlas->image_count:1));
+    if(!order) fputs("memory alloc fails",stderr),exit(1);
+    for(int i = 0; i<atlas->image_count; i++){
+        order[i] = &atlas->images[i];
+    }
+    qsort(order, atlas->image_count, sizeof(glib_atlas_image_t*), glib_atlas_compare_height);
+
+    int pad = atlas->padding;
+    for(int i = 0; i<atlas->image_count; i++){
+        glib_atlas_image_t* image = order[i];
+        int x, y;
+        for(int p = 0; p<atlas->page_count && image->page<0; p++){
+            if(glib_skyline_insert(atlas, &atlas->pages[p], image->width+2*pad, image->height+2*pad, &x, &y)){
+                image->page = p;
+            }
+        }
+        if(image->page<0){
+            glib_skyline_insert(atlas, glib_atlas_new_page(atlas), image->width+2*pad, image->height+2*pad, &x, &y);
+            image->page = atlas->page_count-1;
+        }
+        image->x = x+pad;
+        image->y = y+pad;
+        glib_atlas_blit(atlas, image);
+        free(image->pixels);
+        image->pixels = NULL;
+    }
+    free(order);
+
+    // mip levels deeper than the padding would mix the neighbours
+    int max_level = 0;
+    while((2<<max_level)<=pad) max_level++;
+
+    for(int p = 0; p<atlas->page_count; p++){
+        glib_atlas_page_t* page = &atlas->pages[p];
+        glGenTextures(1, &page->texture);
+        glib_register_texture(page->texture);
+        glib_bind_texture(GLIB_TEX_SLOT0, page->texture);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, max_level>0?GL_LINEAR_MIPMAP_LINEAR:GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, max_level);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlas->page_width, atlas->page_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, page->pixels);
+        if(max_level>0){
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        free(page->pixels);
+        page->pixels = NULL;
+        free(page->nodes);
+        page->nodes = NULL;
+    }
+
+    atlas->built = true;
+    return atlas->page_count;
+}
+
+glib_atlas_region_t glib_atlas_get_region(glib_atlas_t* atlas, int region){
+    glib_atlas_region_t result = {0, 0.0f, 0.0f, 0.0f, 0.0f};
+    if(!atlas->built || region<0 || region>=atlas->image_count){
+        result.texture = glib_default_tex;
+        result.u1 = 1.0f;
+        result.v1 = 1.0f;
+        return result;
+    }
+    glib_atlas_image_t* image = &atlas->images[region];
+    result.texture = atlas->pages[image->page].texture;
+    result.u0 = image->x/(float)atlas->page_width;
+    result.v0 = image->y/(float)atlas->page_height;
+    result.u1 = (image->x+image->width)/(float)atlas->page_width;
+    result.v1 = (image->y+image->height)/(float)atlas->page_height;
+    return result;
+}
+
+void glib_set_obj_uv_region(glib_obj_t* obj, glib_atlas_region_t region){
+    const glib_vertex_attrib_t* uv = NULL;
+    for(unsigned int i = 0; i<obj->layout.attrib_count; i++){
+        if(obj->layout.attribs[i].location==2){
+            uv = &obj->layout.attribs[i];
+        }
+    }
+    if(!uv || uv->type!=GLIB_ATTRIB_FLOAT || uv->size<2){
+        fprintf(stderr, "[WARN] glib_set_obj_uv_region needs float texture coords at location 2\n");
+        return;
+    }
+    if(obj->vertex_count==0){
+        return;
+    }
+    size_t stride = obj->layout.stride;
+    size_t size = stride*obj->vertex_count;
+    unsigned char* vertices = (unsigned char*)malloc(size);
+    if(!vertices) fputs("memory alloc fails",stderr),exit(1);
+
+    // the CPU copy of the object may be gone, so the GPU copy is the source
+    glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+    glGetBufferSubData(GL_ARRAY_BUFFER, glib_obj_region_start(obj), size, vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    float first[2];
+    memcpy(first, vertices+uv->offset, sizeof(first));
+    float min_u = first[0], max_u = first[0];
+    float min_v = first[1], max_v = first[1];
+    for(unsigned int i = 1; i<obj->vertex_count; i++){
+        float v[2];
+        memcpy(v, vertices+i*stride+uv->offset, sizeof(v));
+        if(v[0]<min_u) min_u = v[0];
+        if(v[0]>max_u) max_u = v[0];
+        if(v[1]<min_v) min_v = v[1];
+        if(v[1]>max_v) max_v = v[1];
+    }
+    float scale_u = max_u>min_u?(region.u1-region.u0)/(max_u-min_u):0.0f;
+    float scale_v = max_v>min_v?(region.v1-region.v0)/(max_v-min_v):0.0f;
+    for(unsigned int i = 0; i<obj->vertex_count; i++){
+        float v[2];
+        memcpy(v, vertices+i*stride+uv->offset, sizeof(v));
+        v[0] = region.u0+(v[0]-min_u)*scale_u;
+        v[1] = region.v0+(v[1]-min_v)*scale_v;
+        memcpy(vertices+i*stride+uv->offset, v, sizeof(v));
+    }
+
+    glib_update_obj_vertex_data_range(obj, 0, vertices, obj->vertex_count);
+    free(vertices);
+}
+
+typedef struct {
+    unsigned int VAO, VBO, EBO;
+    float* mapped;              // write pointer into the mapped stream range, NULL if not mapped
+    unsigned int quad_count;    // quads written since the last flush
+    unsigned int stream_offset; // first free quad in the stream buffer
+    unsigned int shader;
+    unsigned int texture;
+    unsigned int draw_calls;
+    bool initialized;
+} glib_batch_t;
+
+glib_batch_t glib_batch;
+
+static void glib_batch_init(void){
+    const unsigned int stream_quads = GLIB_BATCH_MAX_QUADS*GLIB_BATCH_STREAM_FACTOR;
+
+    // the index pattern is the same for every quad, so it is uploaded once and shifted with the base vertex
+    unsigned int* indices = (unsigned int*)malloc(sizeof(unsigned int)*6*GLIB_BATCH_MAX_QUADS);
+    if(!indices) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<GLIB_BATCH_MAX_QUADS; i++){
+        indices[i*6+0] = i*4+0;
+        indices[i*6+1] = i*4+1;
+        indices[i*6+2] = i*4+2;
+        indices[i*6+3] = i*4+0;
+        indices[i*6+4] = i*4+2;
+        indices[i*6+5] = i*4+3;
+    }
+
+    glGenVertexArrays(1, &glib_batch.VAO);
+    glGenBuffers(1, &glib_batch.VBO);
+    glGenBuffers(1, &glib_batch.EBO);
+
+    glib_bind_vao(glib_batch.VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, glib_batch.VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*GLIB_VERTEX_FLOAT_COUNT*stream_quads, NULL, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glib_batch.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*6*GLIB_BATCH_MAX_QUADS, indices, GL_STATIC_DRAW);
+    // Coord
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, GLIB_VERTEX_FLOAT_COUNT * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // Color
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, GLIB_VERTEX_FLOAT_COUNT * sizeof(float), (void*)(3*sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // Texture
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, GLIB_VERTEX_FLOAT_COUNT * sizeof(float), (void*)(7 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glib_bind_vao(0);
+    free(indices);
+
+    glib_batch.stream_offset = 0;
+    glib_batch.initialized = true;
+}
+
+static void glib_batch_map(void){
+    const unsigned int stream_quads = GLIB_BATCH_MAX_QUADS*GLIB_BATCH_STREAM_FACTOR;
+    const unsigned int quad_size = sizeof(float)*4*GLIB_VERTEX_FLOAT_COUNT;
+
+    glBindBuffer(GL_ARRAY_BUFFER, glib_batch.VBO);
+    if(glib_batch.stream_offset+GLIB_BATCH_MAX_QUADS>stream_quads){
+        // orphan the storage, the driver keeps the old one alive until the GPU is done with it
+        glBufferData(GL_ARRAY_BUFFER, quad_size*stream_quads, NULL, GL_STREAM_DRAW);
+        glib_batch.stream_offset = 0;
+    }
+    // only the range behind stream_offset is written, the GPU never reads it yet, so no sync is needed
+    glib_batch.mapped = (float*)glMapBufferRange(GL_ARRAY_BUFFER, quad_size*glib_batch.stream_offset, quad_size*GLIB_BATCH_MAX_QUADS,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if(!glib_batch.mapped){
+        fprintf(stderr, "ERROR: cannot map the batch stream buffer\n");
+        exit(-1);
+    }
+}
+
+static void glib_batch_flush(void){
+    if(glib_batch.mapped==NULL){
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, glib_batch.VBO);
+    glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, sizeof(float)*4*GLIB_VERTEX_FLOAT_COUNT*glib_batch.quad_count);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glib_batch.mapped = NULL;
+
+    if(glib_batch.quad_count==0){
+        return;
+    }
+
+    glib_use_shader(glib_batch.shader);
+    glib_use_texture_2d(glib_batch.texture, GLIB_TEX_SLOT0);
+    glib_bind_vao(glib_batch.VAO);
+    glDrawElementsBaseVertex(GL_TRIANGLES, glib_batch.quad_count*6, GL_UNSIGNED_INT, 0, glib_batch.stream_offset*4);
+
+    glib_batch.stream_offset += glib_batch.quad_count;
+    glib_batch.quad_count = 0;
+    glib_batch.draw_calls++;
+}
+
+void glib_batch_begin(void){
+    if(!glib_batch.initialized){
+        glib_batch_init();
+    }
+    glib_batch.quad_count = 0;
+    glib_batch.draw_calls = 0;
+    glib_batch.shader = glib_default_shader;
+    glib_batch.texture = glib_default_tex;
+}
+
+void glib_batch_set_shader(unsigned int shader_id){
+    if(shader_id!=glib_batch.shader){
+        glib_batch_flush();
+        glib_batch.shader = shader_id;
+    }
+}
+
+void glib_batch_set_texture(unsigned int texture){
+    if(texture!=glib_batch.texture){
+        glib_batch_flush();
+        glib_batch.texture = texture;
+    }
+}
+
+void glib_batch_push_vertices(const float* vertices){
+    if(glib_batch.quad_count==GLIB_BATCH_MAX_QUADS){
+        glib_batch_flush();
+    }
+    if(glib_batch.mapped==NULL){
+        glib_batch_map();
+    }
+    memcpy(glib_batch.mapped+glib_batch.quad_count*4*GLIB_VERTEX_FLOAT_COUNT, vertices, sizeof(float)*4*GLIB_VERTEX_FLOAT_COUNT);
+    glib_batch.quad_count++;
+}
+
+void glib_batch_push_quad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, int rgba_hex){
+    float vertices[] = {
+        x1, y1, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x1, y1,
+        x2, y2, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x2, y2,
+        x3, y3, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x3, y3,
+        x4, y4, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x4, y4,
+    };
+    glib_batch_push_vertices(vertices);
+}
+
+void glib_batch_push_rect(float x, float y, float w, float h, float u0, float v0, float u1, float v1, int rgba_hex){
+    float vertices[] = {
+        x,   y+h, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), u0, v1,
+        x+w, y+h, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), u1, v1,
+        x+w, y,   0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), u1, v0,
+        x,   y,   0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), u0, v0,
+    };
+    glib_batch_push_vertices(vertices);
+}
+
+void glib_batch_end(void){
+    glib_batch_flush();
+}
+
+unsigned int glib_batch_get_draw_calls(void){
+    return glib_batch.draw_calls;
+}
+
+typedef struct {
+    int index;                  // glyph index in the font file, for the kerning
+    int page;                   // -1 if the glyph has no bitmap, like the space
+    float x0, y0, x1, y1;       // the quad from the pen position on the baseline, in atlas pixels
+    float u0, v0, u1, v1;       // v0 is the bottom of the quad
+    float advance;
+} glib_glyph_t;
+
+typedef struct {
+    unsigned int codepoint;
+    int glyph;                  // -1 marks an empty slot
+} glib_glyph_slot_t;
+
+typedef struct {
+    int page;
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+} glib_text_quad_t;
+
+// a laid out string in atlas pixels from the start of its baseline, text is NULL in an empty slot
+typedef struct {
+    char* text;
+    unsigned int hash;
+    unsigned int last_frame;
+    glib_text_quad_t* quads;
+    unsigned int quad_count;
+    float width, height;
+} glib_text_layout_t;
+
+struct glib_font_t {
+    stbtt_fontinfo info;
+    glib_mapped_file_t file;
+    float scale;                // font units to atlas pixels
+    float line_height;          // in atlas pixels
+    glib_atlas_t* packer;       // skyline packing of the pages, the glyphs are uploaded as they are rendered
+
+    glib_glyph_t* glyphs;
+    unsigned int glyph_count;
+    unsigned int glyph_cap;
+    glib_glyph_slot_t* slots;   // codepoint -> glyph
+    unsigned int slot_cap;
+
+    glib_text_layout_t* layouts;
+    unsigned int layout_count;
+    unsigned int layout_cap;
+};
+
+// the quads of one atlas texture which wait for glib_flush_text
+typedef struct {
+    unsigned int texture;
+    float* vertices;
+    unsigned int quad_count;
+    unsigned int quad_cap;
+} glib_text_batch_t;
+
+typedef struct {
+    glib_text_batch_t* batches;
+    unsigned int batch_count;
+    unsigned int frame;
+    unsigned int draw_calls;
+} glib_text_t;
+
+glib_text_t glib_text = {NULL, 0, 1, 0};
+
+glib_font_t* glib_load_font(const char* file_path){
+    glib_font_t* font = (glib_font_t*)calloc(1, sizeof(glib_font_t));
+    if(!font) fputs("memory alloc fails",stderr),exit(1);
+
+    size_t packed_size;
+    const unsigned char* data = (const unsigned char*)glib_find_packed(file_path, &packed_size);
+    if(data==NULL){
+        if(!glib_map_file(file_path, &font->file)){
+            fprintf(stderr, "ERROR: cannot open the font %s\n", file_path);
+            exit(-1);
+        }
+        data = (const unsigned char*)font->file.data;
+    }
+    int offset = stbtt_GetFontOffsetForIndex(data, 0);
+    if(offset<0 || !stbtt_InitFont(&font->info, data, offset)){
+        fprintf(stderr, "ERROR: %s is not a TrueType font\n", file_path);
+        exit(-1);
+    }
+    int ascent, descent, line_gap;
+    stbtt_GetFontVMetrics(&font->info, &ascent, &descent, &line_gap);
+    font->scale = stbtt_ScaleForPixelHeight(&font->info, GLIB_FONT_SDF_SIZE);
+    font->line_height = (ascent-descent+line_gap)*font->scale;
+    font->packer = glib_create_atlas(GLIB_FONT_ATLAS_SIZE, GLIB_FONT_ATLAS_SIZE, 0);
+    // the pages are GL_R8
+    font->packer->channels = 1;
+
+    font->slot_cap = 256;
+    font->slots = (glib_glyph_slot_t*)malloc(sizeof(glib_glyph_slot_t)*font->slot_cap);
+    font->layout_cap = GLIB_TEXT_CACHE_SIZE;
+    font->layouts = (glib_text_layout_t*)calloc(font->layout_cap, sizeof(glib_text_layout_t));
+    if(!font->slots || !font->layouts) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<font->slot_cap; i++){
+        font->slots[i].glyph = -1;
+    }
+    return font;
+}
+
+static void glib_text_drop_texture(unsigned int texture){
+    for(unsigned int i = 0; i<glib_text.batch_count; i++){
+        if(glib_text.batches[i].texture==texture){
+            glib_text.batches[i].quad_count = 0;
+        }
+    }
+}
+
+void glib_destroy_font(glib_font_t* font){
+    for(int p = 0; p<font->packer->page_count; p++){
+        glib_text_drop_texture(font->packer->pages[p].texture);
+        glib_release_texture(font->packer->pages[p].texture);
+        free(font->packer->pages[p].nodes);
+    }
+    free(font->packer->pages);
+    free(font->packer);
+    for(unsigned int i = 0; i<font->layout_cap; i++){
+        free(font->layouts[i].text);
+        free(font->layouts[i].quads);
+    }
+    free(font->layouts);
+    free(font->glyphs);
+    free(font->slots);
+    glib_unmap_file(&font->file);
+    free(font);
+}
+
+static unsigned int glib_utf8_next(const char** text){
+    const unsigned char* s = (const unsigned char*)*text;
+    unsigned int codepoint = s[0];
+    int length = codepoint<0x80?1:((codepoint>>5)==0x6?2:((codepoint>>4)==0xE?3:((codepoint>>3)==0x1E?4:0)));
+    if(length==0){
+        *text += 1;
+        return 0xFFFD;
+    }
+    if(length>1){
+        codepoint &= 0x7F>>length;
+    }
+    for(int i = 1; i<length; i++){
+        // a cut sequence stops before the next character, or the terminating NUL
+        if((s[i]&0xC0)!=0x80){
+            *text += i;
+            return 0xFFFD;
+        }
+        codepoint = (codepoint<<6)|(s[i]&0x3F);
+    }
+    *text += length;
+    return codepoint;
+}
+
+static void glib_font_insert_slot(glib_font_t* font, unsigned int codepoint, int glyph){
+    unsigned int mask = font->slot_cap-1;
+    unsigned int slot = (codepoint*2654435761u)&mask;
+    while(font->slots[slot].glyph>=0){
+        slot = (slot+1)&mask;
+    }
+    font->slots[slot].codepoint = codepoint;
+    font->slots[slot].glyph = glyph;
+}
+
+// the page is created with the zeroed pixels of the packer, the glyphs are written into it with glTexSubImage2D.
+// The font owns its pages, they are not in the texture pool so glib_destroy_all leaves them to glib_destroy_font
+static int glib_font_new_page(glib_font_t* font){
+    glib_atlas_page_t* page = glib_atlas_new_page(font->packer);
+    glGenTextures(1, &page->texture);
+    glib_bind_texture_unit(GLIB_TEX_SLOT0);
+    glib_bind_texture(GLIB_TEX_SLOT0, page->texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, GLIB_FONT_ATLAS_SIZE, GLIB_FONT_ATLAS_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, page->pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    free(page->pixels);
+    page->pixels = NULL;
+    return font->packer->page_count-1;
+}
+
+// render the glyph of a codepoint into the atlas the first time it is used
+static const glib_glyph_t* glib_font_glyph(glib_font_t* font, unsigned int codepoint){
+    unsigned int mask = font->slot_cap-1;
+    for(unsigned int slot = (codepoint*2654435761u)&mask; font->slots[slot].glyph>=0; slot = (slot+1)&mask){
+        if(font->slots[slot].codepoint==codepoint){
+            return &font->glyphs[font->slots[slot].glyph];
+        }
+    }
+
+    glib_glyph_t glyph;
+    memset(&glyph, 0, sizeof(glyph));
+    glyph.index = stbtt_FindGlyphIndex(&font->info, codepoint);
+    glyph.page = -1;
+    int advance, left_side_bearing;
+    stbtt_GetGlyphHMetrics(&font->info, glyph.index, &advance, &left_side_bearing);
+    glyph.advance = advance*font->scale;
+
+    int width, height, x_offset, y_offset;
+    unsigned char* sdf = stbtt_GetGlyphSDF(&font->info, font->scale, glyph.index, GLIB_FONT_SDF_PADDING, 128, 128.0f/GLIB_FONT_SDF_PADDING, &width, &height, &x_offset, &y_offset);
+    if(sdf){
+        // a pixel of gap, so the filtering does not read the neighbours
+        if(width+1>GLIB_FONT_ATLAS_SIZE || height+1>GLIB_FONT_ATLAS_SIZE){
+            fprintf(stderr, "ERROR: a %dx%d glyph does not fit into the font atlas (GLIB_FONT_ATLAS_SIZE)\n", width, height);
+            exit(-1);
+        }
+        int x, y;
+        int page = font->packer->page_count-1;
+        if(page<0 || !glib_skyline_insert(font->packer, &font->packer->pages[page], width+1, height+1, &x, &y)){
+            page = glib_font_new_page(font);
+            glib_skyline_insert(font->packer, &font->packer->pages[page], width+1, height+1, &x, &y);
+        }
+
+        // the texture of slot 0 is bound back, a text can be laid out between the draws of the render callback
+        unsigned int bound = glib_gl_state.textures[GLIB_TEX_SLOT0];
+        glib_bind_texture_unit(GLIB_TEX_SLOT0);
+        glib_bind_texture(GLIB_TEX_SLOT0, font->packer->pages[page].texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, sdf);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if(bound!=GLIB_STATE_UNKNOWN){
+            glib_bind_texture(GLIB_TEX_SLOT0, bound);
+        }
+        stbtt_FreeSDF(sdf, font->info.userdata);
+
+        // the bitmap starts with its top row, and its offset goes down from the baseline
+        const float texel = 1.0f/GLIB_FONT_ATLAS_SIZE;
+        glyph.page = page;
+        glyph.x0 = (float)x_offset;
+        glyph.y0 = (float)-(y_offset+height);
+        glyph.x1 = (float)(x_offset+width);
+        glyph.y1 = (float)-y_offset;
+        glyph.u0 = x*texel;
+        glyph.v0 = (y+height)*texel;
+        glyph.u1 = (x+width)*texel;
+        glyph.v1 = y*texel;
+    }
+
+    if(font->glyph_count==font->glyph_cap){
+        font->glyph_cap = font->glyph_cap?font->glyph_cap*2:128;
+        font->glyphs = (glib_glyph_t*)realloc(font->glyphs, sizeof(glib_glyph_t)*font->glyph_cap);
+        if(!font->glyphs) fputs("memory alloc fails",stderr),exit(1);
+    }
+    font->glyphs[font->glyph_count] = glyph;
+    // the map is kept at most half full
+    if((font->glyph_count+1)*2>font->slot_cap){
+        glib_glyph_slot_t* old_slots = font->slots;
+        unsigned int old_cap = font->slot_cap;
+        font->slot_cap *= 2;
+        font->slots = (glib_glyph_slot_t*)malloc(sizeof(glib_glyph_slot_t)*font->slot_cap);
+        if(!font->slots) fputs("memory alloc fails",stderr),exit(1);
+        for(unsigned int i = 0; i<font->slot_cap; i++){
+            font->slots[i].glyph = -1;
+        }
+        for(unsigned int i = 0; i<old_cap; i++){
+            if(old_slots[i].glyph>=0){
+                glib_font_insert_slot(font, old_slots[i].codepoint, old_slots[i].glyph);
+            }
+        }
+        free(old_slots);
+    }
+    glib_font_insert_slot(font, codepoint, font->glyph_count);
+    return &font->glyphs[font->glyph_count++];
+}
+
+// drop the layouts which were not used in this or the last frame, and size the table for the rest
+static void glib_font_evict_layouts(glib_font_t* font){
+    unsigned int kept = 0;
+    for(unsigned int i = 0; i<font->layout_cap; i++){
+        glib_text_layout_t* layout = &font->layouts[i];
+        if(layout->text && layout->last_frame+1<glib_text.frame){
+            free(layout->text);
+            free(layout->quads);
+            layout->text = NULL;
+        }else if(layout->text){
+            kept++;
+        }
+    }
+    unsigned int cap = GLIB_TEXT_CACHE_SIZE;
+    while(cap<kept*2) cap *= 2;
+
+    glib_text_layout_t* layouts = (glib_text_layout_t*)calloc(cap, sizeof(glib_text_layout_t));
+    if(!layouts) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<font->layout_cap; i++){
+        if(font->layouts[i].text){
+            unsigned int slot = font->layouts[i].hash&(cap-1);
+            while(layouts[slot].text) slot = (slot+1)&(cap-1);
+            layouts[slot] = font->layouts[i];
+        }
+    }
+    free(font->layouts);
+    font->layouts = layouts;
+    font->layout_cap = cap;
+    font->layout_count = kept;
+}
+
+static const glib_text_layout_t* glib_font_layout(glib_font_t* font, const char* text){
+    unsigned int hash = glib_hash_str(text);
+    unsigned int slot = hash&(font->layout_cap-1);
+    while(font->layouts[slot].text){
+        glib_text_layout_t* layout = &font->layouts[slot];
+        if(layout->hash==hash && strcmp(layout->text, text)==0){
+            layout->last_frame = glib_text.frame;
+            return layout;
+        }
+        slot = (slot+1)&(font->layout_cap-1);
+    }
+    // the table is kept at most 3/4 full
+    if((font->layout_count+1)*4>font->layout_cap*3){
+        glib_font_evict_layouts(font);
+        slot = hash&(font->layout_cap-1);
+        while(font->layouts[slot].text) slot = (slot+1)&(font->layout_cap-1);
+    }
+
+    glib_profile_scope_t scope = glib_profile_begin("text layout", false);
+    size_t length = strlen(text);
+    glib_text_layout_t* layout = &font->layouts[slot];
+    layout->text = (char*)malloc(length+1);
+    layout->quads = (glib_text_quad_t*)malloc(sizeof(glib_text_quad_t)*(length?length:1));
+    if(!layout->text || !layout->quads) fputs("memory alloc fails",stderr),exit(1);
+    memcpy(layout->text, text, length+1);
+    layout->hash = hash;
+    layout->last_frame = glib_text.frame;
+    layout->quad_count = 0;
+    font->layout_count++;
+
+    float pen_x = 0.0f, pen_y = 0.0f, width = 0.0f;
+    unsigned int lines = 1;
+    int previous = -1;
+    while(*text){
+        unsigned int codepoint = glib_utf8_next(&text);
+        if(codepoint=='\n'){
+            width = fmaxf(width, pen_x);
+            pen_x = 0.0f;
+            pen_y -= font->line_height;
+            lines++;
+            previous = -1;
+            continue;
+        }
+        const glib_glyph_t* glyph = glib_font_glyph(font, codepoint);
+        if(previous>=0){
+            pen_x += stbtt_GetGlyphKernAdvance(&font->info, previous, glyph->index)*font->scale;
+        }
+        if(glyph->page>=0){
+            glib_text_quad_t* quad = &layout->quads[layout->quad_count++];
+            quad->page = glyph->page;
+            quad->x0 = pen_x+glyph->x0;
+            quad->y0 = pen_y+glyph->y0;
+            quad->x1 = pen_x+glyph->x1;
+            quad->y1 = pen_y+glyph->y1;
+            quad->u0 = glyph->u0;
+            quad->v0 = glyph->v0;
+            quad->u1 = glyph->u1;
+            quad->v1 = glyph->v1;
+        }
+        pen_x += glyph->advance;
+        previous = glyph->index;
+    }
+    layout->width = fmaxf(width, pen_x);
+    layout->height = lines*font->line_height;
+    glib_profile_end(scope);
+    return layout;
+}
+
+static glib_text_batch_t* glib_text_batch(unsigned int texture){
+    for(unsigned int i = 0; i<glib_text.batch_count; i++){
+        if(glib_text.batches[i].texture==texture){
+            return &glib_text.batches[i];
+        }
+    }
+    glib_text.batches = (glib_text_batch_t*)realloc(glib_text.batches, sizeof(glib_text_batch_t)*(glib_text.batch_count+1));
+    if(!glib_text.batches) fputs("memory alloc fails",stderr),exit(1);
+    glib_text_batch_t* batch = &glib_text.batches[glib_text.batch_count++];
+    memset(batch, 0, sizeof(glib_text_batch_t));
+    batch->texture = texture;
+    return batch;
+}
+
+void glib_draw_text(glib_font_t* font, const char* text, float x, float y, float size, int rgba_hex){
+    const glib_text_layout_t* layout = glib_font_layout(font, text);
+    float scale = size/GLIB_FONT_SDF_SIZE;
+    float color[4] = {GLIB_HEX_TO_RGBA_F(rgba_hex)};
+
+    glib_text_batch_t* batch = NULL;
+    int batch_page = -1;
+    for(unsigned int i = 0; i<layout->quad_count; i++){
+        const glib_text_quad_t* quad = &layout->quads[i];
+        if(quad->page!=batch_page){
+            batch_page = quad->page;
+            batch = glib_text_batch(font->packer->pages[batch_page].texture);
+        }
+        if(batch->quad_count==batch->quad_cap){
+            batch->quad_cap = batch->quad_cap?batch->quad_cap*2:256;
+            batch->vertices = (float*)realloc(batch->vertices, sizeof(float)*4*GLIB_VERTEX_FLOAT_COUNT*batch->quad_cap);
+            if(!batch->vertices) fputs("memory alloc fails",stderr),exit(1);
+        }
+        float x0 = x+quad->x0*scale, y0 = y+quad->y0*scale;
+        float x1 = x+quad->x1*scale, y1 = y+quad->y1*scale;
+        // the corner order of glib_batch_push_rect
+        float corners[4][4] = {
+            {x0, y1, quad->u0, quad->v1},
+            {x1, y1, quad->u1, quad->v1},
+            {x1, y0, quad->u1, quad->v0},
+            {x0, y0, quad->u0, quad->v0},
+        };
+        float* v = batch->vertices+(size_t)batch->quad_count*4*GLIB_VERTEX_FLOAT_COUNT;
+        for(int c = 0; c<4; c++, v += GLIB_VERTEX_FLOAT_COUNT){
+            v[0] = corners[c][0];
+            v[1] = corners[c][1];
+            v[2] = 0.0f;
+            memcpy(v+3, color, sizeof(color));
+            v[7] = corners[c][2];
+            v[8] = corners[c][3];
+        }
+        batch->quad_count++;
+    }
+}
+
+void glib_measure_text(glib_font_t* font, const char* text, float size, float* width, float* height){
+    const glib_text_layout_t* layout = glib_font_layout(font, text);
+    float scale = size/GLIB_FONT_SDF_SIZE;
+    *width = layout->width*scale;
+    *height = layout->height*scale;
+}
+
+void glib_flush_text(void){
+    glib_text.draw_calls = 0;
+    unsigned int quad_count = 0;
+    for(unsigned int i = 0; i<glib_text.batch_count; i++){
+        quad_count += glib_text.batches[i].quad_count;
+    }
+    if(quad_count>0){
+        glib_profile_scope_t scope = glib_profile_begin("text", false);
+        // pixels to normalized device coords
+        mat4 proj;
+        glm_ortho(0.0f, (float)glib_window_width, 0.0f, (float)glib_window_height, -1.0f, 1.0f, proj);
+        glib_bind_program(glib_text_shader);
+        glib_set_uniform_mat4_handle(glib_get_uniform(glib_text_shader, "proj"), proj);
+
+        // the text blends over the scene without the depth test, the state of the caller is put back after it
+        glib_blend_state_t caller = glib_save_blend_state();
+        glib_set_capability(&glib_gl_state.blend, GL_BLEND, true);
+        glib_set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glib_set_capability(&glib_gl_state.depth_test, GL_DEPTH_TEST, false);
+        // every atlas texture is one draw from the stream buffer, the batch splits only above GLIB_BATCH_MAX_QUADS quads
+        glib_batch_begin();
+        glib_batch_set_shader(glib_text_shader);
+        for(unsigned int i = 0; i<glib_text.batch_count; i++){
+            glib_text_batch_t* batch = &glib_text.batches[i];
+            if(batch->quad_count==0){
+                continue;
+            }
+            glib_batch_set_texture(batch->texture);
+            for(unsigned int q = 0; q<batch->quad_count; q++){
+                glib_batch_push_vertices(batch->vertices+(size_t)q*4*GLIB_VERTEX_FLOAT_COUNT);
+            }
+            batch->quad_count = 0;
+        }
+        glib_batch_end();
+        glib_text.draw_calls = glib_batch_get_draw_calls();
+        glib_restore_blend_state(&caller);
+        glib_profile_end(scope);
+    }
+    glib_text.frame++;
+}
+
+unsigned int glib_text_get_draw_calls(void){
+    return glib_text.draw_calls;
+}
+
+// The sort key of a queued draw, from the most significant bit:
+//  opaque:      layer(8) | 0 | shader(14) | texture(14) | depth(27)
+//  transparent: layer(8) | 1 | inverted depth(27) | shader(14) | texture(14)
+// Only the low 14 bits of the GL names are in the key, draws with colliding names are still drawn right, just less grouped
+typedef struct {
+    unsigned long long key;
+    unsigned int draw;
+} glib_sort_item_t;
+
+typedef struct {
+    glib_draw_t* draws;
+    glib_sort_item_t* items;
+    glib_sort_item_t* sort_buffer;
+    unsigned int count;
+    unsigned int cap;
+} glib_render_queue_t;
+
+glib_render_queue_t glib_render_queue;
+
+// the bits of a non negative float sort like the float, the low mantissa bits are dropped
+static unsigned long long glib_depth_bits(float depth){
+    if(!(depth>0.0f)){
+        return 0;
+    }
+    unsigned int bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits>>4;
+}
 
-const char* glib_default_frag = {
-    "#version 330 core\n"
-    "in vec4 b_col;\n"
-    "in vec2 b_tex_coord;\n"
-    "uniform sampler2D tex0;\n"
-    "out vec4 FragColor;\n"
-    "void main(){\n"
-        "FragColor = texture(tex0, b_tex_coord)*b_col;\n"
-    "}\n"
-};
+static unsigned long long glib_draw_sort_key(const glib_draw_t* draw){
+    const unsigned long long id_mask = 0x3FFF;
+    const unsigned long long depth_mask = 0x7FFFFFF;
+    unsigned long long key = (unsigned long long)draw->layer<<56;
+    unsigned long long shader = draw->shader&id_mask;
+    unsigned long long texture = draw->textures[0]&id_mask;
+    unsigned long long depth = glib_depth_bits(draw->depth);
+    if(draw->transparent){
+        key |= 1ull<<55;
+        key |= (depth_mask-depth)<<28;
+        key |= shader<<14;
+        key |= texture;
+    }else{
+        key |= shader<<41;
+        key |= texture<<27;
+        key |= depth;
+    }
+    return key;
+}
 
-GLFWwindow* glib_window;
+// LSD radix sort on the key bytes, it is stable, so equal keys are drawn in submission order
+// the bytes which are the same in every key are skipped, returns the buffer which holds the result
+static glib_sort_item_t* glib_radix_sort(glib_sort_item_t* items, glib_sort_item_t* buffer, unsigned int count){
+    static unsigned int histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for(unsigned int i = 0; i<count; i++){
+        unsigned long long key = items[i].key;
+        for(int b = 0; b<8; b++){
+            histograms[b][(key>>(b*8))&0xFF]++;
+        }
+    }
 
-unsigned int glib_window_width;
-unsigned int glib_window_height;
+    glib_sort_item_t* src = items;
+    glib_sort_item_t* dst = buffer;
+    for(int b = 0; b<8; b++){
+        unsigned int* histogram = histograms[b];
+        int shift = b*8;
+        if(histogram[(src[0].key>>shift)&0xFF]==count){
+            continue;
+        }
+        unsigned int offset = 0;
+        for(int i = 0; i<256; i++){
+            unsigned int n = histogram[i];
+            histogram[i] = offset;
+            offset += n;
+        }
+        for(unsigned int i = 0; i<count; i++){
+            dst[histogram[(src[i].key>>shift)&0xFF]++] = src[i];
+        }
+        glib_sort_item_t* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    return src;
+}
 
-void (*glib_render_fun)(void) = NULL;
-void (*glib_framebuffer_resize_fun)(int width, int height) = NULL;
+glib_draw_t glib_make_draw(glib_obj_t* obj, unsigned int shader, unsigned int texture){
+    glib_draw_t draw;
+    memset(&draw, 0, sizeof(draw));
+    draw.obj = obj;
+    draw.shader = shader;
+    draw.textures[0] = texture;
+    draw.lod = obj->lod;
+    return draw;
+}
 
-unsigned int glib_default_tex;
+static glib_draw_uniform_t* glib_draw_add_uniform(glib_draw_t* draw, glib_uniform_handle_t uniform, glib_uniform_type type){
+    if(draw->uniform_count>=GLIB_DRAW_UNIFORMS){
+        fprintf(stderr, "ERROR: a queued draw can set %d uniforms at most (GLIB_DRAW_UNIFORMS)\n", GLIB_DRAW_UNIFORMS);
+        exit(-1);
+    }
+    glib_draw_uniform_t* u = &draw->uniforms[draw->uniform_count++];
+    u->uniform = uniform;
+    u->type = type;
+    return u;
+}
 
-unsigned int glib_default_shader;
+void glib_draw_set_uniform1i(glib_draw_t* draw, glib_uniform_handle_t uniform, int value){
+    glib_draw_add_uniform(draw, uniform, GLIB_UNIFORM_INT)->value.i = value;
+}
 
-bool glib_keyboard_pressed[GLIB_MAX_KEYBOARD_KEY_SUPPORTED];
-bool glib_mouse_pressed[GLIB_MAX_MOUSE_BUTTON_SUPPORTED];
-bool glib_mouse_dragging;
-int glib_mouse_drag_button;
-double glib_mouse_pos_x;
-double glib_mouse_pos_y;
+void glib_draw_set_uniform1f(glib_draw_t* draw, glib_uniform_handle_t uniform, float value){
+    glib_draw_add_uniform(draw, uniform, GLIB_UNIFORM_FLOAT)->value.f = value;
+}
 
-const float YAW         = -90.0f;
-const float PITCH       =  0.0f;
-const float SPEED       =  2.5f;
-const float SENSITIVITY =  0.1f;
-const float ZOOM        =  45.0f;
+void glib_draw_set_uniform1d(glib_draw_t* draw, glib_uniform_handle_t uniform, double value){
+    glib_draw_add_uniform(draw, uniform, GLIB_UNIFORM_DOUBLE)->value.d = value;
+}
 
-char* glib_read_from_file(const char* file_name){
-    FILE *fp;
-    long size;
-    char *buffer;
+void glib_draw_set_uniform_mat4(glib_draw_t* draw, glib_uniform_handle_t uniform, mat4 value){
+    memcpy(glib_draw_add_uniform(draw, uniform, GLIB_UNIFORM_MAT4)->value.m, value, sizeof(mat4));
+}
 
-    fp = fopen ( file_name , "rb" );
-    if( !fp ) perror(file_name),exit(1);
+void glib_submit_draw(const glib_draw_t* draw){
+    glib_render_queue_t* queue = &glib_render_queue;
+    if(queue->count==queue->cap){
+        queue->cap = queue->cap?queue->cap*2:256;
+        queue->draws = (glib_draw_t*)realloc(queue->draws, sizeof(glib_draw_t)*queue->cap);
+        queue->items = (glib_sort_item_t*)realloc(queue->items, sizeof(glib_sort_item_t)*queue->cap);
+        queue->sort_buffer = (glib_sort_item_t*)realloc(queue->sort_buffer, sizeof(glib_sort_item_t)*queue->cap);
+        if(!queue->draws || !queue->items || !queue->sort_buffer) fputs("memory alloc fails",stderr),exit(1);
+    }
+    queue->draws[queue->count] = *draw;
+    queue->items[queue->count].key = glib_draw_sort_key(draw);
+    queue->items[queue->count].draw = queue->count;
+    queue->count++;
+}
 
-    fseek( fp , 0L , SEEK_END);
-    size = ftell( fp );
-    rewind( fp );
+void glib_flush_render_queue(void){
+    glib_render_queue_t* queue = &glib_render_queue;
+    if(queue->count==0){
+        return;
+    }
+    glib_profile_scope_t scope = glib_profile_begin("render queue", false);
+
+    glib_sort_item_t* sorted = glib_radix_sort(queue->items, queue->sort_buffer, queue->count);
+
+    // the opaque draws are not blended and write the depth, the transparent ones after them blend without writing it
+    glib_blend_state_t caller = glib_save_blend_state();
+    for(unsigned int i = 0; i<queue->count; i++){
+        glib_draw_t* draw = &queue->draws[sorted[i].draw];
+        glib_set_capability(&glib_gl_state.blend, GL_BLEND, draw->transparent);
+        glib_set_depth_mask(!draw->transparent);
+        if(draw->transparent){
+            glib_set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
 
-    buffer = calloc( 1, size+1 );
-    if( !buffer ) fclose(fp),fputs("memory alloc fails",stderr),exit(1);
+        // the binds and uniforms go through the state and uniform caches, so the repeated ones of a sorted run cost no GL call
+        glib_bind_program(draw->shader);
+        for(int slot = 0; slot<GLIB_DRAW_TEXTURES; slot++){
+            if(draw->textures[slot]){
+                glib_bind_texture(slot, draw->textures[slot]);
+            }
+        }
+        for(unsigned int u = 0; u<draw->uniform_count; u++){
+            glib_draw_uniform_t* uniform = &draw->uniforms[u];
+            switch(uniform->type){
+                case GLIB_UNIFORM_INT:    glib_set_uniform1i_handle(uniform->uniform, uniform->value.i); break;
+                case GLIB_UNIFORM_FLOAT:  glib_set_uniform1f_handle(uniform->uniform, uniform->value.f); break;
+                case GLIB_UNIFORM_DOUBLE: glib_set_uniform1d_handle(uniform->uniform, uniform->value.d); break;
+                case GLIB_UNIFORM_MAT4:   glib_set_uniform_mat4_handle(uniform->uniform, uniform->value.m); break;
+            }
+        }
 
-    if( 1!=fread( buffer , size, 1 , fp) )
-        fclose(fp),free(buffer),fputs("entire read fails",stderr),exit(1);
+        if(draw->instance_count){
+            glib_draw_obj_instanced_lod(draw->obj, draw->instance_count, draw->lod);
+        }else{
+            glib_draw_obj_lod(draw->obj, draw->lod);
+        }
+    }
+    glib_restore_blend_state(&caller);
 
-    fclose(fp);
-    return buffer;
+    queue->count = 0;
+    glib_profile_end(scope);
 }
 
-void glib_init(void){
-    if(!glfwInit()){
-        fprintf(stderr, "ERROR: cannot init glfw\n");
-        exit(-1);
+glib_camera_t* glib_active_camera = NULL;
+bool glib_camera_uploaded = false;
+
+glib_camera_t glib_create_camera(vec3 position){
+    glib_camera_t camera;
+    memset(&camera, 0, sizeof(camera));
+    glm_vec3_copy(position, camera.position);
+    glm_vec3_copy((vec3){0.0f, 1.0f, 0.0f}, camera.world_up);
+    camera.yaw = YAW;
+    camera.pitch = PITCH;
+    camera.movement_speed = SPEED;
+    camera.mouse_sensitivity = SENSITIVITY;
+    camera.zoom = ZOOM;
+    camera.near_plane = 0.1f;
+    camera.far_plane = 100.0f;
+    camera.dirty = true;
+    glib_update_camera(&camera);
+    return camera;
+}
+
+static void glib_camera_update_vectors(glib_camera_t* camera){
+    float yaw = glm_rad(camera->yaw);
+    float pitch = glm_rad(camera->pitch);
+    camera->front[0] = cosf(yaw)*cosf(pitch);
+    camera->front[1] = sinf(pitch);
+    camera->front[2] = sinf(yaw)*cosf(pitch);
+    glm_vec3_normalize(camera->front);
+    glm_vec3_cross(camera->front, camera->world_up, camera->right);
+    glm_vec3_normalize(camera->right);
+    glm_vec3_cross(camera->right, camera->front, camera->up);
+    glm_vec3_normalize(camera->up);
+}
+
+void glib_camera_move(glib_camera_t* camera, glib_camera_movement direction, float dt){
+    float distance = camera->movement_speed*dt;
+    switch(direction){
+        case GLIB_CAMERA_FORWARD:  glm_vec3_muladds(camera->front, distance, camera->position); break;
+        case GLIB_CAMERA_BACKWARD: glm_vec3_muladds(camera->front, -distance, camera->position); break;
+        case GLIB_CAMERA_LEFT:     glm_vec3_muladds(camera->right, -distance, camera->position); break;
+        case GLIB_CAMERA_RIGHT:    glm_vec3_muladds(camera->right, distance, camera->position); break;
+        case GLIB_CAMERA_UP:       glm_vec3_muladds(camera->world_up, distance, camera->position); break;
+        case GLIB_CAMERA_DOWN:     glm_vec3_muladds(camera->world_up, -distance, camera->position); break;
     }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
+    camera->dirty = true;
+}
 
-    printf("[INFO] %s\n", glfwGetVersionString());
-    int nrAttributes;
-    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &nrAttributes);
-    printf("[INFO] Maximum nr of vertex attributes supported: %zu\n", nrAttributes);
+void glib_camera_rotate(glib_camera_t* camera, float x_offset, float y_offset){
+    camera->yaw += x_offset*camera->mouse_sensitivity;
+    camera->pitch += y_offset*camera->mouse_sensitivity;
+    if(camera->pitch>89.0f){
+        camera->pitch = 89.0f;
+    }
+    if(camera->pitch<-89.0f){
+        camera->pitch = -89.0f;
+    }
+    // the direction vectors are used by glib_camera_move before the next update
+    glib_camera_update_vectors(camera);
+    camera->dirty = true;
 }
 
-static void glib_framebuff_resize(GLFWwindow* window, int width, int height){
-    glViewport(0, 0, width, height);
-    if(glib_framebuffer_resize_fun!=NULL){
-        glib_framebuffer_resize_fun(width, height);
+void glib_camera_zoom(glib_camera_t* camera, float offset){
+    camera->zoom -= offset;
+    if(camera->zoom<1.0f){
+        camera->zoom = 1.0f;
     }
-    glib_window_width = width;
-    glib_window_height = height;
+    if(camera->zoom>ZOOM){
+        camera->zoom = ZOOM;
+    }
+    camera->dirty = true;
 }
 
-static void glib_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods){
-    if(action==GLFW_PRESS){
-        glib_keyboard_pressed[key] = true;
-    }else if(action==GLFW_RELEASE){
-        glib_keyboard_pressed[key] = false;
+void glib_camera_set_clip(glib_camera_t* camera, float near_plane, float far_plane){
+    camera->near_plane = near_plane;
+    camera->far_plane = far_plane;
+    camera->dirty = true;
+}
+
+void glib_update_camera(glib_camera_t* camera){
+    float aspect = glib_window_height?(float)glib_window_width/(float)glib_window_height:1.0f;
+    if(!camera->dirty && camera->aspect==aspect){
+        return;
     }
+    camera->aspect = aspect;
+    glib_camera_update_vectors(camera);
+
+    vec3 center;
+    glm_vec3_add(camera->position, camera->front, center);
+    glm_lookat(camera->position, center, camera->up, camera->view);
+    glm_perspective(glm_rad(camera->zoom), aspect, camera->near_plane, camera->far_plane, camera->proj);
+    glm_mat4_mul(camera->proj, camera->view, camera->view_proj);
+    glm_frustum_planes(camera->view_proj, camera->planes);
+    camera->dirty = false;
 }
 
-static void glib_cursor_position_callback(GLFWwindow* window, double xpos, double ypos){
-    glib_mouse_pos_x = xpos;
-    glib_mouse_pos_y = ypos;
+void glib_use_camera(glib_camera_t* camera){
+    glib_active_camera = camera;
 }
 
-static void glib_mouse_button_callback(GLFWwindow* window, int button, int action, int mods){
-    if(action==GLFW_PRESS){
-        glib_mouse_pressed[button] = true;
-        if(!glib_mouse_dragging){
-            glib_mouse_dragging = true;
-            glib_mouse_drag_button = button;
+// sets the view and proj of the default shaders, the uniform cache drops it if the camera did not move
+static void glib_upload_camera(void){
+    if(glib_active_camera==NULL && !glib_camera_uploaded){
+        return;
+    }
+    mat4 view, proj;
+    if(glib_active_camera){
+        glib_update_camera(glib_active_camera);
+        memcpy(view, glib_active_camera->view, sizeof(mat4));
+        memcpy(proj, glib_active_camera->proj, sizeof(mat4));
+    }else{
+        glm_mat4_identity(view);
+        glm_mat4_identity(proj);
+    }
+    glib_camera_uploaded = glib_active_camera!=NULL;
+
+    unsigned int shaders[] = {glib_default_instanced_shader, glib_default_shader};
+    for(unsigned int i = 0; i<GLIB_ARRAY_LEN(shaders); i++){
+        glib_bind_program(shaders[i]);
+        glib_set_uniform_mat4_handle(glib_get_uniform(shaders[i], "view"), view);
+        glib_set_uniform_mat4_handle(glib_get_uniform(shaders[i], "proj"), proj);
+    }
+}
+
+// the frustum planes in SoA order for the SIMD test, the last two lanes repeat the near plane
+typedef struct {
+    float nx[8];
+    float ny[8];
+    float nz[8];
+    float d[8];
+} glib_frustum_t;
+
+typedef enum {
+    GLIB_CULL_OUTSIDE = 0,
+    GLIB_CULL_INTERSECT,
+    GLIB_CULL_INSIDE,
+} glib_cull_result;
+
+static void glib_make_frustum(glib_camera_t* camera, glib_frustum_t* frustum){
+    for(int i = 0; i<8; i++){
+        const float* plane = camera->planes[i<6?i:4];
+        frustum->nx[i] = plane[0];
+        frustum->ny[i] = plane[1];
+        frustum->nz[i] = plane[2];
+        frustum->d[i] = plane[3];
+    }
+}
+
+// a box is outside if it is behind a plane, and inside if it is in front of every plane
+static glib_cull_result glib_frustum_test_aabb(const glib_frustum_t* frustum, const float* min, const float* max){
+    float cx = (min[0]+max[0])*0.5f, cy = (min[1]+max[1])*0.5f, cz = (min[2]+max[2])*0.5f;
+    float ex = (max[0]-min[0])*0.5f, ey = (max[1]-min[1])*0.5f, ez = (max[2]-min[2])*0.5f;
+    bool inside = true;
+#ifdef __SSE2__
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 zero = _mm_setzero_ps();
+    __m128 vcx = _mm_set1_ps(cx), vcy = _mm_set1_ps(cy), vcz = _mm_set1_ps(cz);
+    __m128 vex = _mm_set1_ps(ex), vey = _mm_set1_ps(ey), vez = _mm_set1_ps(ez);
+    for(int i = 0; i<8; i += 4){
+        __m128 nx = _mm_loadu_ps(frustum->nx+i);
+        __m128 ny = _mm_loadu_ps(frustum->ny+i);
+        __m128 nz = _mm_loadu_ps(frustum->nz+i);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, vcx), _mm_mul_ps(ny, vcy)), _mm_add_ps(_mm_mul_ps(nz, vcz), _mm_loadu_ps(frustum->d+i)));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(nx, abs_mask), vex), _mm_mul_ps(_mm_and_ps(ny, abs_mask), vey)), _mm_mul_ps(_mm_and_ps(nz, abs_mask), vez));
+        if(_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero))){
+            return GLIB_CULL_OUTSIDE;
         }
-    }else if(action==GLFW_RELEASE){
-        glib_mouse_pressed[button] = false;
-        if(button==glib_mouse_drag_button){
-            glib_mouse_dragging = false;
+        if(_mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero))){
+            inside = false;
+        }
+    }
+#else
+    for(int i = 0; i<6; i++){
+        float distance = frustum->nx[i]*cx+frustum->ny[i]*cy+frustum->nz[i]*cz+frustum->d[i];
+        float radius = fabsf(frustum->nx[i])*ex+fabsf(frustum->ny[i])*ey+fabsf(frustum->nz[i])*ez;
+        if(distance+radius<0.0f){
+            return GLIB_CULL_OUTSIDE;
+        }
+        if(distance-radius<0.0f){
+            inside = false;
         }
     }
+#endif
+    return inside?GLIB_CULL_INSIDE:GLIB_CULL_INTERSECT;
 }
 
-void glib_create_window(int width, int height, const char* title){
-    if(!(glib_window = glfwCreateWindow(width, height, title, NULL, NULL))){
-        fprintf(stderr, "ERROR: cannot create window\n");
-        exit(-1);
+// the world space box around the transformed object space box
+static void glib_transform_aabb(mat4 model, const float* min, const float* max, float* out_min, float* out_max){
+    float center[3], extent[3];
+    for(int i = 0; i<3; i++){
+        center[i] = (min[i]+max[i])*0.5f;
+        extent[i] = (max[i]-min[i])*0.5f;
     }
-
-    glfwMakeContextCurrent(glib_window);
-    GLenum err = glewInit();
-    if (GLEW_OK != err){
-        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
-        exit(-1);
+    for(int i = 0; i<3; i++){
+        float c = model[3][i];
+        float e = 0.0f;
+        for(int j = 0; j<3; j++){
+            c += model[j][i]*center[j];
+            e += fabsf(model[j][i])*extent[j];
+        }
+        out_min[i] = c-e;
+        out_max[i] = c+e;
     }
+}
 
-    glfwSetFramebufferSizeCallback(glib_window, glib_framebuff_resize);
-    glib_window_width = width;
-    glib_window_height = height;
+bool glib_camera_sees_obj(glib_camera_t* camera, glib_obj_t* obj, mat4 model){
+    glib_update_camera(camera);
+    glib_frustum_t frustum;
+    glib_make_frustum(camera, &frustum);
+    float min[3], max[3];
+    glib_transform_aabb(model, obj->bounds_min, obj->bounds_max, min, max);
+    return glib_frustum_test_aabb(&frustum, min, max)!=GLIB_CULL_OUTSIDE;
+}
 
-    glfwSetKeyCallback(glib_window, glib_key_callback);
-    glfwSetCursorPosCallback(glib_window, glib_cursor_position_callback);
-    glfwSetMouseButtonCallback(glib_window, glib_mouse_button_callback);
-    
-    glib_default_shader = glib_create_shader_from_memory(glib_default_vert, glib_default_frag);
+typedef struct {
+    glib_draw_t draw;
+    glib_uniform_handle_t model_uniform;
+    float model[16];
+    float min[3], max[3];   // world space bounds
+    unsigned int lod;       // the LOD of the last frame, for the hysteresis
+} glib_scene_entry_t;
+
+// inner nodes have count 0 and their children at first and first+1, leaves have the entries order[first..first+count)
+typedef struct {
+    float min[3], max[3];
+    unsigned int first;
+    unsigned int count;
+} glib_bvh_node_t;
+
+struct glib_scene_t {
+    glib_scene_entry_t* entries;
+    unsigned int entry_count;
+    unsigned int entry_cap;
+    glib_bvh_node_t* nodes;
+    unsigned int node_count;
+    unsigned int* order;
+    unsigned int* stack;
+    bool rebuild;   // entries were added
+    bool refit;     // models were changed
+};
 
-    glib_default_tex = glib_load_texture_2d_from_memory(glib_default_tex_jpg_raw, GLIB_ARRAY_LEN(glib_default_tex_jpg_raw), 0);
-    glEnable(GL_DEPTH_TEST);
+glib_scene_t* glib_create_scene(void){
+    glib_scene_t* scene = (glib_scene_t*)calloc(1, sizeof(glib_scene_t));
+    if(!scene) fputs("memory alloc fails",stderr),exit(1);
+    return scene;
 }
 
-void glib_clear_color(float r, float g, float b, float a){
-    glClearColor(r, g, b, a);
+static void glib_scene_entry_bounds(glib_scene_entry_t* entry){
+    mat4 model;
+    memcpy(model, entry->model, sizeof(mat4));
+    glib_transform_aabb(model, entry->draw.obj->bounds_min, entry->draw.obj->bounds_max, entry->min, entry->max);
 }
 
-void glib_set_render_callback(void (*render_fun)(void)){
-    glib_render_fun = render_fun;
+int glib_scene_add(glib_scene_t* scene, const glib_draw_t* draw, mat4 model){
+    if(draw->uniform_count>=GLIB_DRAW_UNIFORMS){
+        fprintf(stderr, "ERROR: a draw of a scene can set %d uniforms at most (GLIB_DRAW_UNIFORMS-1)\n", GLIB_DRAW_UNIFORMS-1);
+        exit(-1);
+    }
+    if(scene->entry_count==scene->entry_cap){
+        scene->entry_cap = scene->entry_cap?scene->entry_cap*2:64;
+        scene->entries = (glib_scene_entry_t*)realloc(scene->entries, sizeof(glib_scene_entry_t)*scene->entry_cap);
+        if(!scene->entries) fputs("memory alloc fails",stderr),exit(1);
+    }
+    glib_scene_entry_t* entry = &scene->entries[scene->entry_count];
+    entry->draw = *draw;
+    entry->model_uniform = glib_get_uniform(draw->shader, "model");
+    memcpy(entry->model, model, sizeof(mat4));
+    glib_scene_entry_bounds(entry);
+    entry->lod = draw->lod;
+    scene->rebuild = true;
+    return scene->entry_count++;
 }
 
-void glib_set_framebuffer_resize_callback(void (*framebuffer_resize_fun)(int width, int height)){
-    glib_framebuffer_resize_fun =  framebuffer_resize_fun;
+void glib_scene_set_model(glib_scene_t* scene, int index, mat4 model){
+    if(index<0 || (unsigned int)index>=scene->entry_count){
+        fprintf(stderr, "ERROR: invalid scene index %d\n", index);
+        exit(-1);
+    }
+    glib_scene_entry_t* entry = &scene->entries[index];
+    memcpy(entry->model, model, sizeof(mat4));
+    glib_scene_entry_bounds(entry);
+    scene->refit = true;
 }
 
-bool glib_is_keboard_pressed(int keycode){
-    if(keycode<GLIB_MAX_KEYBOARD_KEY_SUPPORTED){
-        return glib_keyboard_pressed[keycode];
+static void glib_bvh_node_bounds(glib_scene_t* scene, glib_bvh_node_t* node){
+    for(int i = 0; i<3; i++){
+        node->min[i] = GLIB_UNBOUNDED;
+        node->max[i] = -GLIB_UNBOUNDED;
+    }
+    if(node->count==0){
+        for(int c = 0; c<2; c++){
+            glib_bvh_node_t* child = &scene->nodes[node->first+c];
+            for(int i = 0; i<3; i++){
+                node->min[i] = fminf(node->min[i], child->min[i]);
+                node->max[i] = fmaxf(node->max[i], child->max[i]);
+            }
+        }
+        return;
+    }
+    for(unsigned int e = node->first; e<node->first+node->count; e++){
+        glib_scene_entry_t* entry = &scene->entries[scene->order[e]];
+        for(int i = 0; i<3; i++){
+            node->min[i] = fminf(node->min[i], entry->min[i]);
+            node->max[i] = fmaxf(node->max[i], entry->max[i]);
+        }
     }
-    return false;
 }
 
-bool glib_is_mouse_pressed(int mouse_button){
-    if(mouse_button<GLIB_MAX_MOUSE_BUTTON_SUPPORTED){
-        return glib_mouse_pressed[mouse_button];
+// splits at the middle of the longest axis of the entry centers, or at the middle entry if it would leave a side empty
+static void glib_bvh_build_node(glib_scene_t* scene, unsigned int node_index, unsigned int first, unsigned int count){
+    glib_bvh_node_t* node = &scene->nodes[node_index];
+    node->first = first;
+    node->count = count;
+    glib_bvh_node_bounds(scene, node);
+    if(count<=GLIB_BVH_LEAF_SIZE){
+        return;
     }
-    return false;
-}
 
-bool glib_is_mouse_dragging(void){
-    return glib_mouse_dragging;
+    float center_min[3] = {GLIB_UNBOUNDED, GLIB_UNBOUNDED, GLIB_UNBOUNDED};
+    float center_max[3] = {-GLIB_UNBOUNDED, -GLIB_UNBOUNDED, -GLIB_UNBOUNDED};
+    for(unsigned int e = first; e<first+count; e++){
+        glib_scene_entry_t* entry = &scene->entries[scene->order[e]];
+        for(int i = 0; i<3; i++){
+            float c = (entry->min[i]+entry->max[i])*0.5f;
+            center_min[i] = fminf(center_min[i], c);
+            center_max[i] = fmaxf(center_max[i], c);
+        }
+    }
+    int axis = 0;
+    for(int i = 1; i<3; i++){
+        if(center_max[i]-center_min[i]>center_max[axis]-center_min[axis]){
+            axis = i;
+        }
+    }
+    float split = (center_min[axis]+center_max[axis])*0.5f;
+
+    unsigned int mid = first;
+    for(unsigned int e = first; e<first+count; e++){
+        glib_scene_entry_t* entry = &scene->entries[scene->order[e]];
+        if((entry->min[axis]+entry->max[axis])*0.5f<split){
+            unsigned int tmp = scene->order[e];
+            scene->order[e] = scene->order[mid];
+            scene->order[mid] = tmp;
+            mid++;
+        }
+    }
+    if(mid==first || mid==first+count){
+        mid = first+count/2;
+    }
+
+    unsigned int children = scene->node_count;
+    scene->node_count += 2;
+    node->first = children;
+    node->count = 0;
+    glib_bvh_build_node(scene, children, first, mid-first);
+    glib_bvh_build_node(scene, children+1, mid, first+count-mid);
 }
 
-int glib_get_mouse_drag_button(void){
-    return glib_mouse_drag_button;
+static void glib_scene_build(glib_scene_t* scene){
+    unsigned int max_nodes = scene->entry_count*2;
+    scene->nodes = (glib_bvh_node_t*)realloc(scene->nodes, sizeof(glib_bvh_node_t)*max_nodes);
+    scene->order = (unsigned int*)realloc(scene->order, sizeof(unsigned int)*scene->entry_count);
+    scene->stack = (unsigned int*)realloc(scene->stack, sizeof(unsigned int)*max_nodes);
+    if(!scene->nodes || !scene->order || !scene->stack) fputs("memory alloc fails",stderr),exit(1);
+    for(unsigned int i = 0; i<scene->entry_count; i++){
+        scene->order[i] = i;
+    }
+    scene->node_count = 1;
+    glib_bvh_build_node(scene, 0, 0, scene->entry_count);
+    scene->rebuild = false;
+    scene->refit = false;
 }
 
-double glib_get_mouse_pos_x(void){
-    return (glib_mouse_pos_x/(double)glib_window_width)*2.0-1.0;
+// the children are always after their parent, so a reverse walk updates them first
+static void glib_scene_refit(glib_scene_t* scene){
+    for(unsigned int i = scene->node_count; i>0; i--){
+        glib_bvh_node_bounds(scene, &scene->nodes[i-1]);
+    }
+    scene->refit = false;
 }
 
-double glib_get_mouse_pos_y(void){
-    return (glib_mouse_pos_y/(double)glib_window_height)*2.0-1.0;
+static void glib_scene_submit_entry(glib_scene_entry_t* entry, glib_camera_t* camera){
+    glib_draw_t draw = entry->draw;
+    if(entry->model_uniform.index>=0){
+        glib_draw_uniform_t* u = &draw.uniforms[draw.uniform_count++];
+        u->uniform = entry->model_uniform;
+        u->type = GLIB_UNIFORM_MAT4;
+        memcpy(u->value.m, entry->model, sizeof(mat4));
+    }
+    vec3 center = {(entry->min[0]+entry->max[0])*0.5f, (entry->min[1]+entry->max[1])*0.5f, (entry->min[2]+entry->max[2])*0.5f};
+    draw.depth = glm_vec3_distance(center, camera->position);
+    if(draw.obj->lod_count>1){
+        mat4 model;
+        memcpy(model, entry->model, sizeof(mat4));
+        entry->lod = glib_select_obj_lod(draw.obj, model, camera, entry->lod);
+        draw.lod = entry->lod;
+    }
+    glib_submit_draw(&draw);
 }
 
-void glib_main_loop(void){
-    while(!glfwWindowShouldClose(glib_window)){
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        glib_use_texture_2d(glib_default_tex, GLIB_TEX_SLOT0);
-        glib_use_shader(glib_default_shader);
-        if(glib_render_fun!=NULL){
-            glib_render_fun();
+unsigned int glib_scene_submit(glib_scene_t* scene, glib_camera_t* camera){
+    if(scene->entry_count==0){
+        return 0;
+    }
+    glib_profile_scope_t scope = glib_profile_begin("scene culling", false);
+    if(scene->rebuild){
+        glib_scene_build(scene);
+    }else if(scene->refit){
+        glib_scene_refit(scene);
+    }
+    glib_update_camera(camera);
+    glib_frustum_t frustum;
+    glib_make_frustum(camera, &frustum);
+
+    // the low bit of a stack item tells that the node is inside the frustum, so its subtree is not tested
+    unsigned int submitted = 0;
+    unsigned int top = 0;
+    scene->stack[top++] = 0;
+    while(top>0){
+        unsigned int item = scene->stack[--top];
+        glib_bvh_node_t* node = &scene->nodes[item>>1];
+        glib_cull_result result = (item&1)?GLIB_CULL_INSIDE:glib_frustum_test_aabb(&frustum, node->min, node->max);
+        if(result==GLIB_CULL_OUTSIDE){
+            continue;
+        }
+        if(node->count==0){
+            unsigned int inside = result==GLIB_CULL_INSIDE;
+            scene->stack[top++] = ((node->first+1)<<1)|inside;
+            scene->stack[top++] = (node->first<<1)|inside;
+            continue;
+        }
+        for(unsigned int e = node->first; e<node->first+node->count; e++){
+            glib_scene_entry_t* entry = &scene->entries[scene->order[e]];
+            if(result==GLIB_CULL_INSIDE || glib_frustum_test_aabb(&frustum, entry->min, entry->max)!=GLIB_CULL_OUTSIDE){
+                glib_scene_submit_entry(entry, camera);
+                submitted++;
+            }
         }
-
-        glfwPollEvents();
-        glfwSwapBuffers(glib_window);
-
     }
-    glfwDestroyWindow(glib_window);
-    glfwTerminate();
+    glib_profile_end(scope);
+    return submitted;
 }
 
-glib_obj_t* glib_create_obj(float* vertices, unsigned int vertices_len, unsigned int* indices, unsigned int indices_len){
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+void glib_destroy_scene(glib_scene_t* scene){
+    free(scene->entries);
+    free(scene->nodes);
+    free(scene->order);
+    free(scene->stack);
+    free(scene);
+}
 
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
+// The pools keep their items in pages of GLIB_POOL_PAGE_SIZE, so an item never moves while the pool grows.
+// A handle is generation(32) | kind(4) | slot(28), the generation of a slot is odd while it is alive
+#define GLIB_POOL_SLOT_MASK 0x0FFFFFFFu
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*vertices_len, vertices, GL_STATIC_DRAW);
+typedef enum {
+    GLIB_POOL_OBJ = 1,
+    GLIB_POOL_SHADER,
+    GLIB_POOL_TEXTURE,
+    GLIB_POOL_MESH,
+} glib_pool_kind;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*indices_len, indices, GL_STATIC_DRAW);
-    // Coord
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Color
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3*sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // Texture
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(7 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+typedef struct {
+    glib_pool_kind kind;
+    size_t item_size;
+    unsigned char** pages;
+    unsigned int* generations;
+    unsigned int* free_slots;
+    unsigned int free_count;
+    unsigned int slot_count;
+} glib_pool_t;
+
+// the shader and texture pools hold the GL names, the tables map the names back to the slots
+typedef struct {
+    glib_pool_t pool;
+    unsigned int* slots;    // indexed by the GL name, slot+1, 0 means not in the pool
+    unsigned int slot_cap;
+} glib_name_pool_t;
 
-    // note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    
-    // remember: do NOT unbind the EBO while a VAO is active as the bound element buffer object IS stored in the VAO; keep the EBO bound.
-    //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+glib_pool_t glib_obj_pool = {.kind = GLIB_POOL_OBJ, .item_size = sizeof(glib_obj_t)};
+glib_name_pool_t glib_shader_pool = {.pool = {.kind = GLIB_POOL_SHADER, .item_size = sizeof(unsigned int)}};
+glib_name_pool_t glib_texture_pool = {.pool = {.kind = GLIB_POOL_TEXTURE, .item_size = sizeof(unsigned int)}};
 
-    glBindVertexArray(0);
-    glib_obj_t* obj = (glib_obj_t*)malloc(sizeof(glib_obj_t));
-    obj->VAO = VAO;
-    obj->VBO = VBO;
-    obj->EBO = EBO;
-    obj->vertices = vertices;
-    obj->vertex_len = vertices_len;
-    obj->indices = indices;
-    obj->index_len = indices_len;
-    return obj;
+static void* glib_pool_item(glib_pool_t* pool, unsigned int slot){
+    return pool->pages[slot/GLIB_POOL_PAGE_SIZE]+(size_t)(slot%GLIB_POOL_PAGE_SIZE)*pool->item_size;
+}
+
+static bool glib_pool_alive(glib_pool_t* pool, unsigned int slot){
+    return slot<pool->slot_count && (pool->generations[slot]&1);
+}
+
+static unsigned int glib_pool_alloc(glib_pool_t* pool){
+    unsigned int slot;
+    if(pool->free_count>0){
+        slot = pool->free_slots[--pool->free_count];
+    }else{
+        slot = pool->slot_count++;
+        if(slot%GLIB_POOL_PAGE_SIZE==0){
+            unsigned int page_count = slot/GLIB_POOL_PAGE_SIZE+1;
+            size_t slot_cap = (size_t)page_count*GLIB_POOL_PAGE_SIZE;
+            pool->pages = (unsigned char**)realloc(pool->pages, sizeof(unsigned char*)*page_count);
+            pool->generations = (unsigned int*)realloc(pool->generations, sizeof(unsigned int)*slot_cap);
+            pool->free_slots = (unsigned int*)realloc(pool->free_slots, sizeof(unsigned int)*slot_cap);
+            if(!pool->pages || !pool->generations || !pool->free_slots) fputs("memory alloc fails",stderr),exit(1);
+            pool->pages[page_count-1] = (unsigned char*)malloc(pool->item_size*GLIB_POOL_PAGE_SIZE);
+            if(!pool->pages[page_count-1]) fputs("memory alloc fails",stderr),exit(1);
+            memset(pool->generations+slot, 0, sizeof(unsigned int)*GLIB_POOL_PAGE_SIZE);
+        }
+    }
+    pool->generations[slot]++;
+    memset(glib_pool_item(pool, slot), 0, pool->item_size);
+    return slot;
+}
+
+static void glib_pool_free(glib_pool_t* pool, unsigned int slot){
+    pool->generations[slot]++;
+    pool->free_slots[pool->free_count++] = slot;
+}
+
+static glib_handle_t glib_pool_handle(glib_pool_t* pool, unsigned int slot){
+    return ((glib_handle_t)pool->generations[slot]<<32)|((glib_handle_t)pool->kind<<28)|slot;
 }
 
-glib_obj_t* glib_create_obj_from_vert(float* vertices, unsigned int vertices_len){
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+// the slot of a handle, or -1 if the handle is stale or belongs to another pool
+static long long glib_pool_find(glib_pool_t* pool, glib_handle_t handle){
+    unsigned int slot = (unsigned int)(handle&GLIB_POOL_SLOT_MASK);
+    if(((handle>>28)&0xF)!=pool->kind || !glib_pool_alive(pool, slot) || pool->generations[slot]!=(unsigned int)(handle>>32)){
+        return -1;
+    }
+    return slot;
+}
 
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
+static void glib_name_pool_add(glib_name_pool_t* names, unsigned int name){
+    if(name>=names->slot_cap){
+        unsigned int new_cap = names->slot_cap?names->slot_cap:64;
+        while(new_cap<=name) new_cap *= 2;
+        names->slots = (unsigned int*)realloc(names->slots, sizeof(unsigned int)*new_cap);
+        if(!names->slots) fputs("memory alloc fails",stderr),exit(1);
+        memset(names->slots+names->slot_cap, 0, sizeof(unsigned int)*(new_cap-names->slot_cap));
+        names->slot_cap = new_cap;
+    }
+    if(names->slots[name]){
+        return;
+    }
+    unsigned int slot = glib_pool_alloc(&names->pool);
+    *(unsigned int*)glib_pool_item(&names->pool, slot) = name;
+    names->slots[name] = slot+1;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*vertices_len, vertices, GL_STATIC_DRAW);
+static glib_handle_t glib_name_pool_handle(glib_name_pool_t* names, unsigned int name){
+    if(name>=names->slot_cap || names->slots[name]==0){
+        return GLIB_INVALID_HANDLE;
+    }
+    return glib_pool_handle(&names->pool, names->slots[name]-1);
+}
 
-    // Coord
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Color
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3*sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // Texture
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(7 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+static unsigned int glib_name_pool_get(glib_name_pool_t* names, glib_handle_t handle){
+    long long slot = glib_pool_find(&names->pool, handle);
+    return slot<0?0:*(unsigned int*)glib_pool_item(&names->pool, (unsigned int)slot);
+}
 
-    // note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    
-    // remember: do NOT unbind the EBO while a VAO is active as the bound element buffer object IS stored in the VAO; keep the EBO bound.
-    //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+static bool glib_name_pool_remove(glib_name_pool_t* names, unsigned int name){
+    if(name>=names->slot_cap || names->slots[name]==0){
+        return false;
+    }
+    glib_pool_free(&names->pool, names->slots[name]-1);
+    names->slots[name] = 0;
+    return true;
+}
 
-    glBindVertexArray(0);
-    glib_obj_t* obj = (glib_obj_t*)malloc(sizeof(glib_obj_t));
-    obj->VAO = VAO;
-    obj->VBO = VBO;
-    obj->vertices = vertices;
-    obj->vertex_len = vertices_len;
+static glib_obj_t* glib_alloc_obj(void){
+    unsigned int slot = glib_pool_alloc(&glib_obj_pool);
+    glib_obj_t* obj = (glib_obj_t*)glib_pool_item(&glib_obj_pool, slot);
+    obj->handle = glib_pool_handle(&glib_obj_pool, slot);
     return obj;
 }
 
-glib_obj_t* glib_create_triangle_obj(float x1, float y1, float x2, float y2, float x3, float y3){
-    float vertices[] = {
-        x1, y1, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x1, y1,
-        x2, y2, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x2, y2,
-        x3, y3, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x3, y3,
-    };
-    
-    unsigned int indices[] = {
-        0, 1, 2
-    };
-
-    return glib_create_obj(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+static void glib_register_shader(unsigned int shader_id){
+    glib_name_pool_add(&glib_shader_pool, shader_id);
 }
-glib_obj_t* glib_create_triangle_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, int rgba_hex){
-    float vertices[] = {
-        x1, y1, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x1, y1,
-        x2, y2, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x2, y2,
-        x3, y3, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x3, y3,
-    };
-    
-    unsigned int indices[] = {
-        0, 1, 2
-    };
 
-    return glib_create_obj(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+static void glib_register_texture(unsigned int texture){
+    glib_name_pool_add(&glib_texture_pool, texture);
 }
 
-glib_obj_t* glib_create_quad_obj(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4){
-    float vertices[] = {
-        x1, y1, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x1, y1,
-        x2, y2, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x2, y2,
-        x3, y3, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x3, y3,
-        x4, y4, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, x4, y4,
-    };
-    
-    unsigned int indices[] = {
-        0, 1, 2,
-        0, 2, 3,
-    };
+// GL objects wait in the batch of the frame they were destroyed in, until the fence behind that frame is signaled
+typedef struct {
+    GLenum type;    // GL_BUFFER, GL_VERTEX_ARRAY, GL_PROGRAM or GL_TEXTURE
+    unsigned int name;
+} glib_gl_garbage_t;
 
-    return glib_create_obj(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+typedef struct {
+    glib_gl_garbage_t* items;
+    unsigned int count;
+    unsigned int cap;
+    GLsync fence;
+} glib_garbage_batch_t;
+
+glib_garbage_batch_t glib_garbage[GLIB_GARBAGE_BATCHES];
+unsigned int glib_garbage_current = 0;
+
+static void glib_defer_delete(GLenum type, unsigned int name){
+    if(name==0){
+        return;
+    }
+    glib_garbage_batch_t* batch = &glib_garbage[glib_garbage_current];
+    if(batch->count==batch->cap){
+        batch->cap = batch->cap?batch->cap*2:64;
+        batch->items = (glib_gl_garbage_t*)realloc(batch->items, sizeof(glib_gl_garbage_t)*batch->cap);
+        if(!batch->items) fputs("memory alloc fails",stderr),exit(1);
+    }
+    batch->items[batch->count].type = type;
+    batch->items[batch->count].name = name;
+    batch->count++;
 }
-glib_obj_t* glib_create_quad_obj_ex(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, int rgba_hex){
-    float vertices[] = {
-        x1, y1, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x1, y1,
-        x2, y2, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x2, y2,
-        x3, y3, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x3, y3,
-        x4, y4, 0.0f, GLIB_HEX_TO_RGBA_F(rgba_hex), x4, y4,
-    };
-    
-    unsigned int indices[] = {
-        0, 1, 2,
-        0, 2, 3,
-    };
 
-    return glib_create_obj(vertices, GLIB_ARRAY_LEN(vertices), indices, GLIB_ARRAY_LEN(indices));
+static void glib_delete_garbage(glib_garbage_batch_t* batch){
+    for(unsigned int i = 0; i<batch->count; i++){
+        unsigned int name = batch->items[i].name;
+        switch(batch->items[i].type){
+            case GL_BUFFER:       glDeleteBuffers(1, &name); break;
+            case GL_VERTEX_ARRAY: glDeleteVertexArrays(1, &name); break;
+            case GL_PROGRAM:      glDeleteProgram(name); break;
+            case GL_TEXTURE:      glDeleteTextures(1, &name); break;
+        }
+    }
+    batch->count = 0;
+    if(batch->fence){
+        glDeleteSync(batch->fence);
+        batch->fence = NULL;
+    }
 }
 
-void glib_draw_obj(glib_obj_t* obj){
-    glBindVertexArray(obj->VAO);
-    if(obj->index_len==0){
-        glDrawArrays(GL_TRIANGLES, 0, obj->vertex_len);
-    }else{
-        glDrawElements(GL_TRIANGLES, obj->index_len, GL_UNSIGNED_INT, 0);
+void glib_collect_garbage(bool wait){
+    glib_garbage_batch_t* current = &glib_garbage[glib_garbage_current];
+    if(current->count>0){
+        current->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glib_garbage_current = (glib_garbage_current+1)%GLIB_GARBAGE_BATCHES;
+    }
+    for(int i = 0; i<GLIB_GARBAGE_BATCHES; i++){
+        glib_garbage_batch_t* batch = &glib_garbage[i];
+        if(batch->fence==NULL){
+            continue;
+        }
+        GLenum status = glClientWaitSync(batch->fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait?GL_TIMEOUT_IGNORED:0);
+        if(status!=GL_TIMEOUT_EXPIRED){
+            glib_delete_garbage(batch);
+        }
+    }
+    // every batch is in flight, the oldest one has to be finished before it takes the new garbage
+    glib_garbage_batch_t* next = &glib_garbage[glib_garbage_current];
+    if(next->fence){
+        glClientWaitSync(next->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glib_delete_garbage(next);
     }
 }
 
-void glib_wired_draw(){
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+glib_handle_t glib_obj_handle(glib_obj_t* obj){
+    return obj->handle;
 }
 
-void glib_filled_draw(){
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+glib_obj_t* glib_get_obj(glib_handle_t handle){
+    long long slot = glib_pool_find(&glib_obj_pool, handle);
+    return slot<0?NULL:(glib_obj_t*)glib_pool_item(&glib_obj_pool, (unsigned int)slot);
 }
 
-int compile_shader(GLenum shader_type, const char* shader_thing, int from_memory){
-    GLint is_compiled = 0;
-    /* Calls the Function that loads the Shader source code from a file */
-    const char* shader_source;
-    if(from_memory){
-        shader_source = shader_thing;
-        printf("%s\n", shader_source);
-    }else{
-        shader_source = glib_read_from_file(shader_thing); 
-        printf("%s: %s\n", shader_thing, shader_source);
-    }
-
-    int shader_id = glCreateShader(shader_type);
-    if(shader_id == 0) {
-        printf("COULD NOT LOAD SHADER: %s!\n", from_memory?shader_thing:"");
+void glib_destroy_obj(glib_obj_t* obj){
+    long long slot = glib_pool_find(&glib_obj_pool, obj->handle);
+    if(slot<0){
+        fprintf(stderr, "ERROR: the object is already destroyed\n");
         exit(-1);
     }
+    if(glib_gl_state.VAO==(unsigned int)obj->VAO){
+        glib_gl_state.VAO = GLIB_STATE_UNKNOWN;
+    }
+    glib_defer_delete(GL_VERTEX_ARRAY, obj->VAO);
+    glib_defer_delete(GL_BUFFER, obj->VBO);
+    glib_defer_delete(GL_BUFFER, obj->EBO);
+    glib_defer_delete(GL_BUFFER, obj->instance_VBO);
+    for(int i = 0; i<GLIB_BUFFER_RING_SIZE; i++){
+        if(obj->fences[i]){
+            glDeleteSync(obj->fences[i]);
+        }
+    }
+    if(obj->owns_vertices){
+        free(obj->vertices);
+    }
+    if(obj->owns_indices){
+        free(obj->indices);
+    }
+    glib_pool_free(&glib_obj_pool, (unsigned int)slot);
+}
 
-    glShaderSource(shader_id, 1, (const char**)&shader_source, NULL);
-    glCompileShader(shader_id);
-    glGetShaderiv(shader_id, GL_COMPILE_STATUS, &is_compiled);
+glib_handle_t glib_shader_handle(unsigned int shader_id){
+    return glib_name_pool_handle(&glib_shader_pool, shader_id);
+}
 
-    if(is_compiled == GL_FALSE) {
-        GLint max_len = 0;
-        char info_log[1024];
-	    glGetShaderiv(shader_id, GL_INFO_LOG_LENGTH, &max_len);
-        glGetShaderInfoLog(shader_id, max_len, &max_len, info_log);
+unsigned int glib_get_shader(glib_handle_t handle){
+    return glib_name_pool_get(&glib_shader_pool, handle);
+}
 
-        printf("%s\n", info_log);
-        fprintf(stderr, "Shader Compiler Error: %s\n", from_memory?shader_thing:"");
-        glDeleteShader(shader_id);
-        exit(-1);
+void glib_destroy_shader(unsigned int shader_id){
+    if(!glib_name_pool_remove(&glib_shader_pool, shader_id)){
+        fprintf(stderr, "[WARN] glib_destroy_shader: %u is not a glib shader\n", shader_id);
+        return;
     }
-
-    return shader_id;
+    if(glib_gl_state.program==shader_id){
+        glib_gl_state.program = GLIB_STATE_UNKNOWN;
+    }
+    // the name can come back from glCreateProgram after the delete, the uniform table is made again then
+    if(shader_id<glib_program_info_cap){
+        free(glib_program_infos[shader_id].uniforms);
+        glib_program_infos[shader_id].uniforms = NULL;
+        glib_program_infos[shader_id].uniform_count = 0;
+        glib_program_infos[shader_id].uniform_cap = 0;
+    }
+    glib_defer_delete(GL_PROGRAM, shader_id);
 }
 
-int link_shader(GLuint vertex_shader_id, GLuint fragment_shader_id){
-    GLuint program_id = 0;
-    GLint is_linked = 0;
-    GLint max_len = 0;
-    char info_log[1024];
+glib_handle_t glib_texture_handle(unsigned int texture){
+    return glib_name_pool_handle(&glib_texture_pool, texture);
+}
 
-    program_id = glCreateProgram();
+unsigned int glib_get_texture(glib_handle_t handle){
+    return glib_name_pool_get(&glib_texture_pool, handle);
+}
 
-    glAttachShader(program_id, vertex_shader_id);
-    glAttachShader(program_id, fragment_shader_id);
+// forget the bindings of a texture and delete it when the GPU is done with it
+static void glib_release_texture(unsigned int texture){
+    for(int i = 0; i<GLIB_TEX_SLOT_COUNT; i++){
+        if(glib_gl_state.textures[i]==texture){
+            glib_gl_state.textures[i] = GLIB_STATE_UNKNOWN;
+        }
+    }
+    glib_defer_delete(GL_TEXTURE, texture);
+}
 
-    glLinkProgram(program_id);
+void glib_destroy_texture(unsigned int texture){
+    if(!glib_name_pool_remove(&glib_texture_pool, texture)){
+        fprintf(stderr, "[WARN] glib_destroy_texture: %u is not a glib texture\n", texture);
+        return;
+    }
+    glib_release_texture(texture);
+}
 
-    glGetProgramiv(program_id, GL_LINK_STATUS, &is_linked);
-    if(is_linked == GL_FALSE) {
-        printf("Shader Program Linker Error\n");
-        
-	    glGetProgramiv(program_id, GL_INFO_LOG_LENGTH, &max_len);
-        glGetProgramInfoLog(program_id, max_len, &max_len, info_log);
+void glib_destroy_all(void){
+    for(unsigned int slot = 0; slot<glib_obj_pool.slot_count; slot++){
+        if(glib_pool_alive(&glib_obj_pool, slot)){
+            glib_destroy_obj((glib_obj_t*)glib_pool_item(&glib_obj_pool, slot));
+        }
+    }
+    for(unsigned int slot = 0; slot<glib_shader_pool.pool.slot_count; slot++){
+        unsigned int shader_id = *(unsigned int*)glib_pool_item(&glib_shader_pool.pool, slot);
+        if(glib_pool_alive(&glib_shader_pool.pool, slot) && shader_id!=glib_default_shader && shader_id!=glib_default_instanced_shader && shader_id!=glib_text_shader){
+            glib_destroy_shader(shader_id);
+        }
+    }
+    for(unsigned int slot = 0; slot<glib_texture_pool.pool.slot_count; slot++){
+        unsigned int texture = *(unsigned int*)glib_pool_item(&glib_texture_pool.pool, slot);
+        if(glib_pool_alive(&glib_texture_pool.pool, slot) && texture!=glib_default_tex){
+            glib_destroy_texture(texture);
+        }
+    }
+}
 
-        printf("%s\n", info_log);
+// free ranges of an arena buffer sorted by offset, the neighbours are merged when a range is freed
+#define GLIB_ARENA_FULL 0xFFFFFFFFu
 
-        glDeleteProgram(program_id);
+typedef struct {
+    unsigned int offset;
+    unsigned int size;
+} glib_arena_block_t;
 
-        glDeleteShader(vertex_shader_id);
-        glDeleteShader(fragment_shader_id);
+typedef struct {
+    glib_arena_block_t* blocks;
+    unsigned int count;
+    unsigned int cap;
+} glib_free_list_t;
 
-        exit(-1);
-    }
+typedef struct {
+    unsigned int first_vertex;
+    unsigned int vertex_count;
+    unsigned int first_index;
+    unsigned int index_count;
+} glib_arena_mesh_t;
 
-    glDetachShader(program_id, vertex_shader_id);
-    glDetachShader(program_id, fragment_shader_id);
+// the layout of glMultiDrawElementsIndirect
+typedef struct {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+} glib_draw_elements_command_t;
+
+struct glib_arena_t {
+    glib_vertex_layout_t layout;
+    unsigned int VAO, VBO, EBO;
+    unsigned int instance_VBO;
+    unsigned int indirect_buffer;
+    unsigned int vertex_capacity;
+    unsigned int index_capacity;
+    glib_free_list_t free_vertices;
+    glib_free_list_t free_indices;
+    glib_pool_t meshes;
+    bool indirect;  // glMultiDrawElementsIndirect with base instances is supported
+    bool instance_arrays;   // the instance attributes read the instance buffer, otherwise they are constants
+
+    // per draw scratch arrays
+    glib_draw_elements_command_t* commands;
+    GLsizei* counts;
+    void** offsets;
+    GLint* base_vertices;
+    unsigned int draw_cap;
+    size_t instance_capacity;   // in bytes
+    size_t indirect_capacity;
+};
 
-    glDeleteShader(vertex_shader_id);
-    glDeleteShader(fragment_shader_id);
+static void glib_free_list_reset(glib_free_list_t* list, unsigned int offset, unsigned int size){
+    list->count = 0;
+    if(size==0){
+        return;
+    }
+    if(list->cap==0){
+        list->cap = 16;
+        list->blocks = (glib_arena_block_t*)malloc(sizeof(glib_arena_block_t)*list->cap);
+        if(!list->blocks) fputs("memory alloc fails",stderr),exit(1);
+    }
+    list->blocks[0].offset = offset;
+    list->blocks[0].size = size;
+    list->count = 1;
+}
 
-    return program_id;
+// first fit, returns GLIB_ARENA_FULL if no block is big enough
+static unsigned int glib_free_list_alloc(glib_free_list_t* list, unsigned int size){
+    for(unsigned int i = 0; i<list->count; i++){
+        glib_arena_block_t* block = &list->blocks[i];
+        if(block->size<size){
+            continue;
+        }
+        unsigned int offset = block->offset;
+        block->offset += size;
+        block->size -= size;
+        if(block->size==0){
+            memmove(block, block+1, sizeof(glib_arena_block_t)*(list->count-i-1));
+            list->count--;
+        }
+        return offset;
+    }
+    return GLIB_ARENA_FULL;
 }
 
-unsigned int glib_create_shader(const char* vert_file_path, const char* frag_file_path){
-    GLuint vert_id = compile_shader(GL_VERTEX_SHADER, vert_file_path, 0);
-    GLuint frag_id = compile_shader(GL_FRAGMENT_SHADER, frag_file_path, 0);
-    
-    return link_shader(vert_id, frag_id);
+static void glib_free_list_free(glib_free_list_t* list, unsigned int offset, unsigned int size){
+    if(size==0){
+        return;
+    }
+    unsigned int i = 0;
+    while(i<list->count && list->blocks[i].offset<offset) i++;
+
+    bool merge_prev = i>0 && list->blocks[i-1].offset+list->blocks[i-1].size==offset;
+    bool merge_next = i<list->count && offset+size==list->blocks[i].offset;
+    if(merge_prev && merge_next){
+        list->blocks[i-1].size += size+list->blocks[i].size;
+        memmove(&list->blocks[i], &list->blocks[i+1], sizeof(glib_arena_block_t)*(list->count-i-1));
+        list->count--;
+    }else if(merge_prev){
+        list->blocks[i-1].size += size;
+    }else if(merge_next){
+        list->blocks[i].offset = offset;
+        list->blocks[i].size += size;
+    }else{
+        if(list->count==list->cap){
+            list->cap = list->cap?list->cap*2:16;
+            list->blocks = (glib_arena_block_t*)realloc(list->blocks, sizeof(glib_arena_block_t)*list->cap);
+            if(!list->blocks) fputs("memory alloc fails",stderr),exit(1);
+        }
+        memmove(&list->blocks[i+1], &list->blocks[i], sizeof(glib_arena_block_t)*(list->count-i));
+        list->blocks[i].offset = offset;
+        list->blocks[i].size = size;
+        list->count++;
+    }
 }
 
-unsigned int glib_create_shader_from_memory(const char* vert_src, const char* frag_src){
-    GLuint vert_id = compile_shader(GL_VERTEX_SHADER, vert_src, 1);
-    GLuint frag_id = compile_shader(GL_FRAGMENT_SHADER, frag_src, 1);
-    
-    return link_shader(vert_id, frag_id);
+static unsigned int glib_free_list_total(glib_free_list_t* list){
+    unsigned int total = 0;
+    for(unsigned int i = 0; i<list->count; i++){
+        total += list->blocks[i].size;
+    }
+    return total;
 }
 
-void glib_use_shader(int shader_id){
-    glUseProgram(shader_id);
+static void glib_arena_setup_vao(glib_arena_t* arena){
+    glib_bind_vao(arena->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, arena->VBO);
+    for(unsigned int i = 0; i<arena->layout.attrib_count; i++){
+        const glib_vertex_attrib_t* attrib = &arena->layout.attribs[i];
+        glVertexAttribPointer(attrib->location, attrib->size, glib_gl_attrib_type(attrib->type), attrib->normalized?GL_TRUE:GL_FALSE, arena->layout.stride, (void*)(size_t)attrib->offset);
+        glEnableVertexAttribArray(attrib->location);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena->EBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, arena->instance_VBO);
+    for(int i = 0; i<4; i++){
+        glVertexAttribPointer(GLIB_INSTANCE_MODEL_LOCATION+i, 4, GL_FLOAT, GL_FALSE, sizeof(glib_instance_t), (void*)(offsetof(glib_instance_t, model)+i*sizeof(vec4)));
+        glEnableVertexAttribArray(GLIB_INSTANCE_MODEL_LOCATION+i);
+        glVertexAttribDivisor(GLIB_INSTANCE_MODEL_LOCATION+i, 1);
+    }
+    glVertexAttribPointer(GLIB_INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(glib_instance_t), (void*)offsetof(glib_instance_t, color));
+    glEnableVertexAttribArray(GLIB_INSTANCE_COLOR_LOCATION);
+    glVertexAttribDivisor(GLIB_INSTANCE_COLOR_LOCATION, 1);
+    arena->instance_arrays = true;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glib_bind_vao(0);
 }
 
-void glib_set_uniform1i(int program_id, const char* name, int value){
-    glUniform1i(glGetUniformLocation(program_id, name), value);
+// without instance data the instance attributes are an identity model and white, so no draw reads the instances of an older call or an empty buffer.
+// The constant values are not the state of the VAO, so they are set for every such draw
+static void glib_arena_use_instances(glib_arena_t* arena, bool enabled){
+    if(arena->instance_arrays!=enabled){
+        for(int i = 0; i<4; i++){
+            if(enabled){
+                glEnableVertexAttribArray(GLIB_INSTANCE_MODEL_LOCATION+i);
+            }else{
+                glDisableVertexAttribArray(GLIB_INSTANCE_MODEL_LOCATION+i);
+            }
+        }
+        if(enabled){
+            glEnableVertexAttribArray(GLIB_INSTANCE_COLOR_LOCATION);
+        }else{
+            glDisableVertexAttribArray(GLIB_INSTANCE_COLOR_LOCATION);
+        }
+        arena->instance_arrays = enabled;
+    }
+    if(!enabled){
+        for(int i = 0; i<4; i++){
+            glVertexAttrib4f(GLIB_INSTANCE_MODEL_LOCATION+i, i==0?1.0f:0.0f, i==1?1.0f:0.0f, i==2?1.0f:0.0f, i==3?1.0f:0.0f);
+        }
+        glVertexAttrib4f(GLIB_INSTANCE_COLOR_LOCATION, 1.0f, 1.0f, 1.0f, 1.0f);
+    }
 }
 
-void glib_set_uniform1f(int program_id, const char* name, float value){
-    glUniform1f(glGetUniformLocation(program_id, name), value);
+glib_arena_t* glib_create_arena(const glib_vertex_layout_t* layout, unsigned int vertex_capacity, unsigned int index_capacity){
+    if(layout->attrib_count>GLIB_MAX_VERTEX_ATTRIBS || layout->stride==0){
+        fprintf(stderr, "ERROR: invalid vertex layout\n");
+        exit(-1);
+    }
+    glib_arena_t* arena = (glib_arena_t*)calloc(1, sizeof(glib_arena_t));
+    if(!arena) fputs("memory alloc fails",stderr),exit(1);
+    arena->layout = *layout;
+    arena->vertex_capacity = vertex_capacity?vertex_capacity:1;
+    arena->index_capacity = index_capacity?index_capacity:1;
+    arena->meshes.kind = GLIB_POOL_MESH;
+    arena->meshes.item_size = sizeof(glib_arena_mesh_t);
+    arena->indirect = GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance;
+
+    glGenVertexArrays(1, &arena->VAO);
+    glGenBuffers(1, &arena->VBO);
+    glGenBuffers(1, &arena->EBO);
+    glGenBuffers(1, &arena->instance_VBO);
+    glGenBuffers(1, &arena->indirect_buffer);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena->VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (size_t)arena->vertex_capacity*layout->stride, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena->EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(unsigned int)*arena->index_capacity, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glib_arena_setup_vao(arena);
+
+    glib_free_list_reset(&arena->free_vertices, 0, arena->vertex_capacity);
+    glib_free_list_reset(&arena->free_indices, 0, arena->index_capacity);
+    return arena;
 }
 
-void glib_set_uniform1d(int program_id, const char* name, double value){
-    glUniform1d(glGetUniformLocation(program_id, name), value);
+// copies the meshes next to each other into new buffers of the given capacity
+static void glib_arena_relocate(glib_arena_t* arena, unsigned int vertex_capacity, unsigned int index_capacity){
+    glib_profile_scope_t scope = glib_profile_begin("arena relocate", false);
+    size_t stride = arena->layout.stride;
+    unsigned int VBO, EBO;
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (size_t)vertex_capacity*stride, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(unsigned int)*index_capacity, NULL, GL_STATIC_DRAW);
+
+    unsigned int vertex_end = 0, index_end = 0;
+    for(unsigned int slot = 0; slot<arena->meshes.slot_count; slot++){
+        if(!glib_pool_alive(&arena->meshes, slot)){
+            continue;
+        }
+        glib_arena_mesh_t* mesh = (glib_arena_mesh_t*)glib_pool_item(&arena->meshes, slot);
+        glBindBuffer(GL_COPY_READ_BUFFER, arena->VBO);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+        if(mesh->vertex_count){
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, mesh->first_vertex*stride, vertex_end*stride, mesh->vertex_count*stride);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, arena->EBO);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+        if(mesh->index_count){
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sizeof(unsigned int)*mesh->first_index, sizeof(unsigned int)*index_end, sizeof(unsigned int)*mesh->index_count);
+        }
+        mesh->first_vertex = vertex_end;
+        mesh->first_index = index_end;
+        vertex_end += mesh->vertex_count;
+        index_end += mesh->index_count;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // the draws of the last frames may still read the old buffers
+    glib_defer_delete(GL_BUFFER, arena->VBO);
+    glib_defer_delete(GL_BUFFER, arena->EBO);
+    arena->VBO = VBO;
+    arena->EBO = EBO;
+    arena->vertex_capacity = vertex_capacity;
+    arena->index_capacity = index_capacity;
+    glib_arena_setup_vao(arena);
+
+    glib_free_list_reset(&arena->free_vertices, vertex_end, vertex_capacity-vertex_end);
+    glib_free_list_reset(&arena->free_indices, index_end, index_capacity-index_end);
+    glib_profile_end(scope);
 }
 
-void glib_set_unifrom_mat4(int program_id, const char* name, mat4 value){
-    glUniformMatrix4fv(glGetUniformLocation(program_id, name), 1, GL_FALSE, (float*)value);
+void glib_arena_defragment(glib_arena_t* arena){
+    glib_arena_relocate(arena, arena->vertex_capacity, arena->index_capacity);
 }
 
-unsigned int glib_load_texture_2d(const char* file_path, unsigned char has_alpha){
-    unsigned int tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+static unsigned int glib_arena_grown_capacity(unsigned int capacity, unsigned int free_size, unsigned int size){
+    unsigned int used = capacity-free_size;
+    unsigned int needed = used+size;
+    if(size<=free_size){
+        return capacity;
+    }
+    while(capacity<needed) capacity *= 2;
+    return capacity;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+glib_handle_t glib_arena_add_mesh(glib_arena_t* arena, const void* vertices, unsigned int vertex_count, const unsigned int* indices, unsigned int index_count){
+    unsigned int first_vertex = glib_free_list_alloc(&arena->free_vertices, vertex_count);
+    unsigned int first_index = glib_free_list_alloc(&arena->free_indices, index_count);
+    if(first_vertex==GLIB_ARENA_FULL || first_index==GLIB_ARENA_FULL){
+        // the free space is too fragmented or too small, the meshes are compacted into big enough buffers
+        if(first_vertex!=GLIB_ARENA_FULL){
+            glib_free_list_free(&arena->free_vertices, first_vertex, vertex_count);
+        }
+        if(first_index!=GLIB_ARENA_FULL){
+            glib_free_list_free(&arena->free_indices, first_index, index_count);
+        }
+        unsigned int vertex_capacity = glib_arena_grown_capacity(arena->vertex_capacity, glib_free_list_total(&arena->free_vertices), vertex_count);
+        unsigned int index_capacity = glib_arena_grown_capacity(arena->index_capacity, glib_free_list_total(&arena->free_indices), index_count);
+        glib_arena_relocate(arena, vertex_capacity, index_capacity);
+        first_vertex = glib_free_list_alloc(&arena->free_vertices, vertex_count);
+        first_index = glib_free_list_alloc(&arena->free_indices, index_count);
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    unsigned int slot = glib_pool_alloc(&arena->meshes);
+    glib_arena_mesh_t* mesh = (glib_arena_mesh_t*)glib_pool_item(&arena->meshes, slot);
+    mesh->first_vertex = vertex_count?first_vertex:0;
+    mesh->vertex_count = vertex_count;
+    mesh->first_index = index_count?first_index:0;
+    mesh->index_count = index_count;
+
+    size_t stride = arena->layout.stride;
+    if(vertex_count){
+        glBindBuffer(GL_ARRAY_BUFFER, arena->VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, mesh->first_vertex*stride, vertex_count*stride, vertices);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if(index_count){
+        // the element buffer binding is part of the VAO
+        glib_bind_vao(arena->VAO);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int)*mesh->first_index, sizeof(unsigned int)*index_count, indices);
+    }
+    return glib_pool_handle(&arena->meshes, slot);
+}
 
-    int width, height, n_channels;
-    stbi_set_flip_vertically_on_load(1);
-    unsigned char *data = stbi_load(file_path, &width, &height, &n_channels, 0);
-    if(data){
-        glTexImage2D(GL_TEXTURE_2D, 0, has_alpha?GL_RGBA:GL_RGB, width, height, 0, has_alpha?GL_RGBA:GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }else{
-        fprintf(stderr, "Failed to load texture. %s\n", file_path);
-        exit(-1);
+void glib_arena_remove_mesh(glib_arena_t* arena, glib_handle_t mesh_handle){
+    long long slot = glib_pool_find(&arena->meshes, mesh_handle);
+    if(slot<0){
+        return;
     }
-    stbi_image_free(data);
+    glib_arena_mesh_t* mesh = (glib_arena_mesh_t*)glib_pool_item(&arena->meshes, (unsigned int)slot);
+    glib_free_list_free(&arena->free_vertices, mesh->first_vertex, mesh->vertex_count);
+    glib_free_list_free(&arena->free_indices, mesh->first_index, mesh->index_count);
+    glib_pool_free(&arena->meshes, (unsigned int)slot);
+}
 
-    return tex;
+static void glib_arena_reserve_draws(glib_arena_t* arena, unsigned int count){
+    if(count<=arena->draw_cap){
+        return;
+    }
+    while(arena->draw_cap<count) arena->draw_cap = arena->draw_cap?arena->draw_cap*2:64;
+    arena->commands = (glib_draw_elements_command_t*)realloc(arena->commands, sizeof(glib_draw_elements_command_t)*arena->draw_cap);
+    arena->counts = (GLsizei*)realloc(arena->counts, sizeof(GLsizei)*arena->draw_cap);
+    arena->offsets = (void**)realloc(arena->offsets, sizeof(void*)*arena->draw_cap);
+    arena->base_vertices = (GLint*)realloc(arena->base_vertices, sizeof(GLint)*arena->draw_cap);
+    if(!arena->commands || !arena->counts || !arena->offsets || !arena->base_vertices) fputs("memory alloc fails",stderr),exit(1);
 }
 
-unsigned int glib_load_texture_2d_from_memory(const char* raw_data, unsigned int data_len, unsigned char has_alpha){
-    unsigned int tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+// orphan the old storage, so the upload does not wait for the draws which still read it
+static void glib_arena_upload(GLenum target, unsigned int buffer, size_t* capacity, const void* data, size_t size){
+    glBindBuffer(target, buffer);
+    if(size>*capacity){
+        *capacity = size;
+    }
+    glBufferData(target, *capacity, NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(target, 0, size, data);
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+void glib_arena_draw(glib_arena_t* arena, const glib_handle_t* meshes, const glib_instance_t* instances, unsigned int count){
+    glib_profile_scope_t scope = glib_profile_begin("glib_arena_draw", false);
+    glib_arena_reserve_draws(arena, count);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // the removed meshes are dropped, the instance i still belongs to meshes[i]
+    unsigned int draw_count = 0;
+    for(unsigned int i = 0; i<count; i++){
+        long long slot = glib_pool_find(&arena->meshes, meshes[i]);
+        if(slot<0){
+            continue;
+        }
+        glib_arena_mesh_t* mesh = (glib_arena_mesh_t*)glib_pool_item(&arena->meshes, (unsigned int)slot);
+        if(mesh->index_count==0){
+            continue;
+        }
+        glib_draw_elements_command_t* command = &arena->commands[draw_count++];
+        command->count = mesh->index_count;
+        command->instance_count = 1;
+        command->first_index = mesh->first_index;
+        command->base_vertex = (GLint)mesh->first_vertex;
+        command->base_instance = i;
+    }
+    if(draw_count==0){
+        glib_profile_end(scope);
+        return;
+    }
 
-    int width, height, n_channels;
-    stbi_set_flip_vertically_on_load(1);
-    unsigned char *data = stbi_load_from_memory(raw_data, data_len, &width, &height, &n_channels, 0);
-    if(data){
-        glTexImage2D(GL_TEXTURE_2D, 0, has_alpha?GL_RGBA:GL_RGB, width, height, 0, has_alpha?GL_RGBA:GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    glib_bind_vao(arena->VAO);
+    if(instances){
+        glib_arena_upload(GL_ARRAY_BUFFER, arena->instance_VBO, &arena->instance_capacity, instances, sizeof(glib_instance_t)*count);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glib_arena_use_instances(arena, instances!=NULL);
+
+    if(arena->indirect){
+        glib_arena_upload(GL_DRAW_INDIRECT_BUFFER, arena->indirect_buffer, &arena->indirect_capacity, arena->commands, sizeof(glib_draw_elements_command_t)*draw_count);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0, draw_count, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }else if(instances){
+        // without base instances the instance attributes are pointed to the instance of each draw
+        glBindBuffer(GL_ARRAY_BUFFER, arena->instance_VBO);
+        for(unsigned int i = 0; i<draw_count; i++){
+            glib_draw_elements_command_t* command = &arena->commands[i];
+            size_t base = sizeof(glib_instance_t)*command->base_instance;
+            for(int c = 0; c<4; c++){
+                glVertexAttribPointer(GLIB_INSTANCE_MODEL_LOCATION+c, 4, GL_FLOAT, GL_FALSE, sizeof(glib_instance_t), (void*)(base+offsetof(glib_instance_t, model)+c*sizeof(vec4)));
+            }
+            glVertexAttribPointer(GLIB_INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(glib_instance_t), (void*)(base+offsetof(glib_instance_t, color)));
+            glDrawElementsBaseVertex(GL_TRIANGLES, command->count, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int)*command->first_index), command->base_vertex);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glib_arena_setup_vao(arena);
     }else{
-        fprintf(stderr, "Failed to load texture. %p\n", raw_data);
-        exit(-1);
+        for(unsigned int i = 0; i<draw_count; i++){
+            arena->counts[i] = arena->commands[i].count;
+            arena->offsets[i] = (void*)(sizeof(unsigned int)*arena->commands[i].first_index);
+            arena->base_vertices[i] = arena->commands[i].base_vertex;
+        }
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, arena->counts, GL_UNSIGNED_INT, (const void* const*)arena->offsets, draw_count, arena->base_vertices);
     }
-    stbi_image_free(data);
-
-    return tex;
+    glib_profile_end(scope);
 }
 
-void glib_use_texture_2d(unsigned int texture, glib_texture_slot slot){
-    switch(slot){
-        case GLIB_TEX_SLOT0:
-        glActiveTexture(GL_TEXTURE0);
-        break;
-        case GLIB_TEX_SLOT1:
-        glActiveTexture(GL_TEXTURE1);
-        break;
-        case GLIB_TEX_SLOT2:
-        glActiveTexture(GL_TEXTURE2);
-        break;
-        case GLIB_TEX_SLOT3:
-        glActiveTexture(GL_TEXTURE3);
-        break;
-        case GLIB_TEX_SLOT4:
-        glActiveTexture(GL_TEXTURE4);
-        break;
-        case GLIB_TEX_SLOT5:
-        glActiveTexture(GL_TEXTURE5);
-        break;
-        case GLIB_TEX_SLOT6:
-        glActiveTexture(GL_TEXTURE6);
-        break;
-        case GLIB_TEX_SLOT7:
-        glActiveTexture(GL_TEXTURE7);
-        break;
-        case GLIB_TEX_SLOT8:
-        glActiveTexture(GL_TEXTURE8);
-        break;
-        case GLIB_TEX_SLOT9:
-        glActiveTexture(GL_TEXTURE9);
-        break;
-        case GLIB_TEX_SLOT10:
-        glActiveTexture(GL_TEXTURE10);
-        break;
-        case GLIB_TEX_SLOT11:
-        glActiveTexture(GL_TEXTURE11);
-        break;
-        case GLIB_TEX_SLOT12:
-        glActiveTexture(GL_TEXTURE12);
-        break;
-        case GLIB_TEX_SLOT13:
-        glActiveTexture(GL_TEXTURE13);
-        break;
-        case GLIB_TEX_SLOT14:
-        glActiveTexture(GL_TEXTURE14);
-        break;
-        case GLIB_TEX_SLOT15:
-        glActiveTexture(GL_TEXTURE15);
-        break;
-        case GLIB_TEX_SLOT16:
-        glActiveTexture(GL_TEXTURE16);
-        break;
-        case GLIB_TEX_SLOT17:
-        glActiveTexture(GL_TEXTURE17);
-        break;
-        default:
-        glActiveTexture(GL_TEXTURE0);
+void glib_destroy_arena(glib_arena_t* arena){
+    if(glib_gl_state.VAO==arena->VAO){
+        glib_gl_state.VAO = GLIB_STATE_UNKNOWN;
     }
-
-    glBindTexture(GL_TEXTURE_2D, texture);
+    glib_defer_delete(GL_VERTEX_ARRAY, arena->VAO);
+    glib_defer_delete(GL_BUFFER, arena->VBO);
+    glib_defer_delete(GL_BUFFER, arena->EBO);
+    glib_defer_delete(GL_BUFFER, arena->instance_VBO);
+    glib_defer_delete(GL_BUFFER, arena->indirect_buffer);
+    free(arena->free_vertices.blocks);
+    free(arena->free_indices.blocks);
+    for(unsigned int page = 0; page*GLIB_POOL_PAGE_SIZE<arena->meshes.slot_count; page++){
+        free(arena->meshes.pages[page]);
+    }
+    free(arena->meshes.pages);
+    free(arena->meshes.generations);
+    free(arena->meshes.free_slots);
+    free(arena->commands);
+    free(arena->counts);
+    free(arena->offsets);
+    free(arena->base_vertices);
+    free(arena);
 }
 
 #endif //GLIB_IMPLEMENTATION